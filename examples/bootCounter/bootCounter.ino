@@ -0,0 +1,87 @@
+/**
+    @file     bootCounter.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Keep a boot counter and the last shutdown reason in the ÖnÖffBTN's
+    User-EEPROM using the wear-leveled record store.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the power supply of your Arduino to the power-output of the ÖnÖffBTN
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_records.h"
+
+#define SHUTDOWN_UNKNOWN    (0)
+#define SHUTDOWN_BUTTON     (1)
+
+// our record: 4 bytes, which gives us 2 slots to rotate through
+typedef struct
+{
+  uint16_t BootCount;
+  uint8_t LastShutdownReason;
+  uint8_t Reserved;
+} BootRecord;
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_RecordStore store(btn, sizeof(BootRecord), 1);   // layout version 1
+BootRecord bootRecord;
+
+// loop status variables
+volatile bool interruptReceived = false;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  if(!store.read((uint8_t *)&bootRecord))
+  {
+    Serial.println("No boot record yet");
+    memset(&bootRecord, 0, sizeof(bootRecord));
+  }
+
+  Serial.print("Boot count: ");
+  Serial.println(bootRecord.BootCount);
+  Serial.print("Last shutdown reason: ");
+  Serial.println(bootRecord.LastShutdownReason);
+
+  // count this boot, the reason is unknown until we shut down properly
+  bootRecord.BootCount++;
+  bootRecord.LastShutdownReason = SHUTDOWN_UNKNOWN;
+  store.write((const uint8_t *)&bootRecord);
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+}
+
+void loop()
+{
+  if(interruptReceived)
+  {
+    interruptReceived = false;
+
+    if(btn.getButtonStatus().LongPress)
+    {
+      bootRecord.LastShutdownReason = SHUTDOWN_BUTTON;
+      store.write((const uint8_t *)&bootRecord);
+
+      btn.TriggerLatch();
+    }
+  }
+
+  delay(10);
+}
+
+void handleBtnInterrupt()
+{
+  interruptReceived = true;
+}
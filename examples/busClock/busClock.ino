@@ -0,0 +1,86 @@
+/**
+    @file     busClock.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Bus clock negotiation example for the ÖnÖffBTN with an Arduino.
+
+    Measures the framebuffer throughput at 100kHz and 400kHz, then lets the
+    driver pick the fastest clock the bus handles reliably (up to 1MHz,
+    Fast-mode Plus) and measures again. The result depends a lot on the
+    bus: short wires and strong pull-ups help.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - open the serial monitor (115200 baud)
+
+    Visit https://hhtronik.com for more information
+*/
+
+
+#include "hhtronik_onoffbtn.h"
+
+#define FRAMES    (200)
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+void setup() 
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  // we're driving the framebuffer ourselves, and negotiateBusClock() needs
+  // it to hold still
+  btn.selectAnimation(PowerOn, Animation_None);
+
+  measure(100000);
+  measure(400000);
+
+  uint32_t clock = btn.negotiateBusClock();
+  Serial.print("Negotiated clock: ");
+  Serial.print(clock);
+  Serial.println("Hz");
+
+  measure(clock);
+}
+
+void loop() 
+{
+  // keep an eye on the bus: the driver steps the clock down
+  // by itself when transfers start to fail
+  Serial.print("Clock: ");
+  Serial.print(btn.getBusClock());
+  Serial.print("Hz, bus errors: ");
+  Serial.println(btn.getBusErrorCount());
+
+  delay(5000);
+}
+
+void measure(uint32_t clock)
+{
+  btn.setBusClock(clock);
+  btn.resetBusErrorCount();
+
+  uint32_t start = micros();
+
+  // full frames, a moving dot
+  for(uint16_t f = 0; f < FRAMES; f++)
+  {
+    memset(frame, 0, sizeof(frame));
+    frame[f % ONOFFBTN_FRAMEBUFFER_SIZE] = 255;
+    btn.setPixels(frame, ONOFFBTN_FRAMEBUFFER_SIZE);
+  }
+
+  uint32_t elapsed = micros() - start;
+
+  Serial.print(clock / 1000);
+  Serial.print("kHz: ");
+  Serial.print(elapsed / FRAMES);
+  Serial.print("us per frame, ");
+  Serial.print(FRAMES * 1000000UL / elapsed);
+  Serial.print(" frames/s, bus errors: ");
+  Serial.println(btn.getBusErrorCount());
+}
@@ -0,0 +1,113 @@
+/**
+    @file     busScheduler.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Status read latency under full animation load, with and without the
+    bus scheduler.
+
+    The sketch streams a rainbow to the LED ring as fast as the bus allows
+    (every subpixel changes on every frame). Each button press prints the
+    time from the INT edge to the end of the status read, and the worst
+    case so far.
+
+    - direct: frames are sent with setPixels(), the status is read between
+      two frames
+    - scheduler: frames go through HHTronik_OnOffBTN_Scheduler, the status
+      read preempts the frame at the next chunk boundary
+
+    Double click to switch between both modes.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+    - open the serial monitor (115200 baud)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_scheduler.h"
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_Scheduler scheduler = HHTronik_OnOffBTN_Scheduler(btn);
+
+uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+uint8_t hue = 0;
+bool useScheduler = true;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  // we're driving the framebuffer ourselves
+  btn.selectAnimation(PowerOn, Animation_None);
+  btn.clearFramebuffer();
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+
+  Serial.println("mode: scheduler");
+}
+
+void loop()
+{
+  renderRainbow(hue++);
+
+  if(useScheduler)
+  {
+    // a new frame as soon as the previous one is out
+    scheduler.queueFrame(frame);
+    while(scheduler.poll()) ;
+  }
+  else
+  {
+    btn.setPixels(frame, ONOFFBTN_FRAMEBUFFER_SIZE);
+    scheduler.poll(0);      // status read only
+  }
+
+  if(scheduler.hasStatus())
+  {
+    uint8_t status = scheduler.takeStatus();
+
+    if(status & ONOFFBTN_STATUS_DOUBLECLICK)
+    {
+      useScheduler = !useScheduler;
+      scheduler.resetStatusLatency();
+      Serial.println(useScheduler ? "mode: scheduler" : "mode: direct");
+    }
+    else if(status & ONOFFBTN_STATUS_SHORTPRESS)
+    {
+      Serial.print("status latency: ");
+      Serial.print(scheduler.getLastStatusLatency());
+      Serial.print("us, worst: ");
+      Serial.print(scheduler.getWorstStatusLatency());
+      Serial.println("us");
+    }
+  }
+}
+
+void renderRainbow(uint8_t offset)
+{
+  for(uint8_t i = 0; i < ONOFFBTN_NUM_PIXELS; i++)
+  {
+    uint8_t h = offset + i * (256 / ONOFFBTN_NUM_PIXELS);
+    uint8_t rise = (h % 85) * 3;
+    uint8_t fall = 255 - rise;
+
+    uint8_t *pixel = frame + i * 3;
+
+    if(h < 85)       { pixel[0] = fall; pixel[1] = rise; pixel[2] = 0; }
+    else if(h < 170) { pixel[0] = 0; pixel[1] = fall; pixel[2] = rise; }
+    else             { pixel[0] = rise; pixel[1] = 0; pixel[2] = fall; }
+  }
+}
+
+void handleBtnInterrupt()
+{
+  scheduler.notifyInterrupt();
+}
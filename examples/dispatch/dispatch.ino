@@ -0,0 +1,84 @@
+/**
+    @file     dispatch.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Handle the ÖnÖffBTN events with a compile-time dispatcher instead of
+    a chain of if(status.X) checks.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_dispatch.h"
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+
+// loop status variables
+volatile bool interruptReceived = false;
+bool ledState = false;
+
+void onShortPress(uint8_t status)
+{
+  Serial.println("Button: short press");
+  ledState = !ledState;
+  digitalWrite(LED_BUILTIN, ledState);
+}
+
+void onDoubleClick(uint8_t status)
+{
+  Serial.println("Button: double click");
+}
+
+void onPowerChanged(uint8_t status)
+{
+  Serial.println((status & ONOFFBTN_STATUS_POWERON) ? "Power: on" : "Power: off");
+}
+
+void onRTCAlarm(uint8_t status)
+{
+  Serial.println("RTC alarm");
+}
+
+// bind the handlers at compile time, unused events cost nothing
+HHTronik_OnOffBTN_Dispatcher<
+  OnOffBTN_IgnoreEvent,   // Down
+  onShortPress,           // ShortPress
+  OnOffBTN_IgnoreEvent,   // LongPress
+  onDoubleClick,          // DoubleClick
+  onPowerChanged,         // PowerOn edge
+  onRTCAlarm              // RTC_Alarm
+> dispatcher;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, ledState);
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+}
+
+void loop()
+{
+  if(interruptReceived)
+  {
+    interruptReceived = false;
+    dispatcher.dispatch(btn);
+  }
+}
+
+void handleBtnInterrupt()
+{
+  interruptReceived = true;
+}
@@ -0,0 +1,96 @@
+/**
+    @file     ditheredBreath.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    A smooth, dim "breathing" status light using temporal dithering, and a
+    benchmark of what it costs.
+
+    Every second the sketch prints:
+    - render: CPU time per frame spent in the dithering stage (us)
+    - show: time per frame spent in render + I2C transfer (us)
+    - subpixels: average number of subpixels sent per frame
+    - bus: share of the frame period spent transferring (%)
+
+    Lower FRAME_INTERVAL_US for less visible flicker, as long as "bus" stays
+    well below 100%.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_dither.h"
+
+#define FRAME_INTERVAL_US   (5000)      // 200 frames per second
+#define BREATH_PERIOD_MS    (4000)
+#define BREATH_MAX_LEVEL    (0x2000)    // stay in the dim range where 8 bit steps show
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_Dither dither;
+
+// benchmark accumulators
+unsigned long lastFrame = 0;
+unsigned long lastReport = 0;
+unsigned long renderTime = 0;
+unsigned long showTime = 0;
+unsigned long subpixelsSent = 0;
+unsigned long frames = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  // we're driving the framebuffer ourselves
+  btn.selectAnimation(PowerOn, Animation_None);
+  btn.clearFramebuffer();
+}
+
+void loop()
+{
+  unsigned long now = micros();
+  if(now - lastFrame < FRAME_INTERVAL_US) return;
+  lastFrame = now;
+
+  // triangle wave, squared for a perceptually smoother fade
+  uint16_t phase = (uint16_t)(((millis() % BREATH_PERIOD_MS) * 65536UL) / BREATH_PERIOD_MS);
+  uint16_t triangle = (phase < 32768) ? phase * 2 : (65535 - phase) * 2;
+  uint16_t level = (uint16_t)(((uint32_t)triangle * triangle >> 16) * BREATH_MAX_LEVEL >> 16);
+
+  for(uint8_t i = 0; i < ONOFFBTN_NUM_PIXELS; i++)
+    dither.setPixel(i, level / 4, level / 2, level);   // a cold white/blue
+
+  // measure the dithering stage alone...
+  uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+  unsigned long start = micros();
+  dither.render(frame);
+  renderTime += micros() - start;
+
+  // ...and the full frame including the transfer
+  start = micros();
+  subpixelsSent += btn.updateFramebuffer(frame);
+  showTime += micros() - start;
+  frames++;
+
+  if(millis() - lastReport >= 1000)
+  {
+    lastReport = millis();
+
+    Serial.print("render: ");
+    Serial.print(renderTime / frames);
+    Serial.print("us show: ");
+    Serial.print((renderTime + showTime) / frames);
+    Serial.print("us subpixels: ");
+    Serial.print(subpixelsSent / frames);
+    Serial.print(" bus: ");
+    Serial.print(showTime * 100 / (frames * FRAME_INTERVAL_US));
+    Serial.println("%");
+
+    renderTime = showTime = subpixelsSent = frames = 0;
+  }
+}
@@ -0,0 +1,86 @@
+/**
+    @file     gestures.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Recognize richer button gestures (triple clicks, long holds, click-then-hold)
+    on the host, without any additional I2C traffic.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_gestures.h"
+
+// the gesture table: { number of presses, min. hold time of the last press in ms }
+const OnOffBTN_Gesture gestures[] =
+{
+  { 1, 0 },       // 0: single click
+  { 3, 0 },       // 1: triple click
+  { 1, 3000 },    // 2: hold for 3 seconds
+  { 1, 8000 },    // 3: hold for 8 seconds (the longest hold: reported without waiting for the release)
+  { 2, 1000 }     // 4: click, then press and hold for 1 second
+};
+
+const char *gestureNames[] =
+{
+  "single click",
+  "triple click",
+  "hold 3s",
+  "hold 8s",
+  "click + hold 1s"
+};
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, sizeof(gestures) / sizeof(gestures[0]));
+
+// loop status variables
+volatile bool interruptReceived = false;
+volatile uint32_t interruptTime = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+}
+
+void loop()
+{
+  int8_t gesture = ONOFFBTN_NO_GESTURE;
+
+  if(interruptReceived)
+  {
+    interruptReceived = false;
+    gesture = recognizer.feed(btn.getButtonStatus(), interruptTime);
+  }
+  else
+  {
+    // multi-click sequences end on a timeout, the longest hold once it's
+    // reached, no I2C involved
+    gesture = recognizer.update(millis());
+  }
+
+  if(gesture != ONOFFBTN_NO_GESTURE)
+  {
+    Serial.print("Gesture: ");
+    Serial.println(gestureNames[gesture]);
+  }
+
+  delay(10);
+}
+
+void handleBtnInterrupt()
+{
+  interruptTime = millis();
+  interruptReceived = true;
+}
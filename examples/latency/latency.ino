@@ -0,0 +1,232 @@
+/**
+    @file     latency.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Press-to-handler latency benchmark for the ÖnÖffBTN, in virtual time.
+
+    The time from a press to your handler is mostly spent waiting for the
+    loop to look at the button, plus one status read on the bus. This sketch
+    first measures what a status read really costs at 100kHz, 400kHz and
+    1MHz, then replays the same series of presses (single presses and
+    double clicks, a few seconds apart) through a model of each reaction
+    strategy, and prints the latency distribution (p50/p99/max, in us):
+
+    - poll 50ms / poll 10ms: getButtonStatus() then delay() in the loop
+    - INT + delay(10): the ISR sets a flag the loop checks (the examples)
+    - INT, free loop: same without the delay()
+    - adaptive 1-64ms: polling every 1ms for 500ms after something
+      happened (to catch double clicks), then the interval doubles on every
+      idle poll up to 64ms
+
+    The latency is counted from the moment the ÖnÖffBTN sets the status bit
+    (and raises INT) to the moment the status read has completed. The time
+    the ÖnÖffBTN takes to classify a press (short/long/double) is the same
+    for every strategy and isn't included. LOOP_WORK_US models the rest of
+    your loop, tune it and the strategies to your sketch.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - open the serial monitor (115200 baud)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+
+#define PRESSES         (200)       // per strategy
+#define LOOP_WORK_US    (500)       // time spent in the rest of the loop per iteration
+#define ISR_US          (10)        // interrupt entry + handler
+#define READ_SAMPLES    (100)
+
+typedef struct
+{
+  const char *name;
+  bool useInterrupt;        // read only when the ISR flagged a change
+  uint32_t minInterval;     // us, delay at the end of each loop iteration
+  uint32_t maxInterval;     // us, > minInterval for adaptive polling
+  uint32_t hold;            // us, adaptive polling stays at minInterval this long after a press
+} Strategy;
+
+const Strategy strategies[] = {
+  { "poll 50ms",        false,  50000,  50000,  0      },
+  { "poll 10ms",        false,  10000,  10000,  0      },
+  { "INT + delay(10)",  true,   10000,  10000,  0      },
+  { "INT, free loop",   true,   0,      0,      0      },
+  { "adaptive 1-64ms",  false,  1000,   64000,  500000 }
+};
+
+const uint32_t clocks[] = { 100000, 400000, 1000000 };
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+
+uint16_t latencies[PRESSES];
+uint32_t random_state;
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  for(uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+  {
+    uint32_t readTime = measureStatusRead(clocks[c]);
+
+    Serial.println();
+    Serial.print(clocks[c] / 1000);
+    Serial.print("kHz, status read: ");
+    Serial.print(readTime);
+    Serial.print("us (");
+    Serial.print(wireTime(clocks[c]));
+    Serial.println("us on the wire)");
+
+    Serial.println("strategy              p50      p99      max");
+
+    for(uint8_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++)
+    {
+      simulate(strategies[s], readTime);
+      report(strategies[s].name);
+    }
+  }
+
+  btn.setBusClock(ONOFFBTN_BUS_CLOCK_DEFAULT);
+}
+
+void loop()
+{
+}
+
+/**
+ * START + address + register, repeated START + address + data, STOP:
+ * ~39 bit times (us)
+ */
+uint32_t wireTime(uint32_t clock)
+{
+  return 39000000UL / clock;
+}
+
+/**
+ * average duration of getRawButtonStatus() at the given clock (us)
+ */
+uint32_t measureStatusRead(uint32_t clock)
+{
+  btn.setBusClock(clock);
+  btn.resetBusErrorCount();
+
+  uint32_t start = micros();
+  for(uint8_t i = 0; i < READ_SAMPLES; i++)
+    btn.getRawButtonStatus();
+  uint32_t elapsed = micros() - start;
+
+  // not connected or the bus doesn't cope with the clock: use the model
+  if(btn.getBusErrorCount() > 0)
+  {
+    Serial.println("warning: bus errors, the status read time is estimated");
+    return wireTime(clock);
+  }
+
+  return elapsed / READ_SAMPLES;
+}
+
+/**
+ * pseudo-random, the same series for every strategy
+ */
+uint32_t nextRandom(uint32_t range)
+{
+  random_state = random_state * 1103515245UL + 12345UL;
+  return (random_state >> 8) % range;
+}
+
+/**
+ * time of the next press: one or two presses (double click) every
+ * 0.5 to 5 seconds
+ */
+uint32_t nextPress(uint32_t previous, bool &secondClick)
+{
+  if(!secondClick && nextRandom(3) == 0)
+  {
+    secondClick = true;
+    return previous + 250000UL + nextRandom(100000UL);
+  }
+
+  secondClick = false;
+  return previous + 500000UL + nextRandom(4500000UL);
+}
+
+/**
+ * replay the presses through a loop using the given strategy, in virtual
+ * time (us), and fill latencies[]
+ */
+void simulate(const Strategy &strategy, uint32_t readTime)
+{
+  random_state = 42;
+
+  bool secondClick = false;
+  uint32_t now = nextRandom(strategy.maxInterval + LOOP_WORK_US + 1);   // loop phase
+  uint32_t interval = strategy.minInterval;
+  uint32_t press = nextPress(0, secondClick);
+  uint32_t lastActivity = 0;
+
+  for(uint16_t p = 0; p < PRESSES; )
+  {
+    // top of the loop
+    bool flagged = (int32_t)(now - (press + ISR_US)) >= 0;
+    bool pending = (int32_t)(now - press) >= 0;
+
+    if(!strategy.useInterrupt || flagged)
+    {
+      // the status bit has to be set when the read starts
+      now += readTime;
+
+      if(pending)
+      {
+        uint32_t latency = now - press;
+        latencies[p++] = latency > 0xffff ? 0xffff : latency;
+        press = nextPress(press, secondClick);
+        interval = strategy.minInterval;
+        lastActivity = now;
+      }
+      else if(interval < strategy.maxInterval && now - lastActivity >= strategy.hold)
+      {
+        interval = interval * 2 > strategy.maxInterval ? strategy.maxInterval : interval * 2;
+      }
+    }
+
+    now += LOOP_WORK_US + interval;
+  }
+}
+
+/**
+ * sort latencies[] and print its distribution
+ */
+void report(const char *name)
+{
+  // insertion sort, small enough
+  for(uint16_t i = 1; i < PRESSES; i++)
+  {
+    uint16_t value = latencies[i];
+    uint16_t j = i;
+
+    for(; j > 0 && latencies[j - 1] > value; j--)
+      latencies[j] = latencies[j - 1];
+
+    latencies[j] = value;
+  }
+
+  Serial.print(name);
+  for(uint8_t i = strlen(name); i < 18; i++) Serial.print(' ');
+
+  printColumn(latencies[PRESSES / 2]);
+  printColumn(latencies[PRESSES * 99 / 100]);
+  printColumn(latencies[PRESSES - 1]);
+  Serial.println();
+}
+
+void printColumn(uint16_t value)
+{
+  char column[10];
+  snprintf(column, sizeof(column), "%9u", value);
+  Serial.print(column);
+}
@@ -0,0 +1,135 @@
+/**
+    @file     lightShow.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Play branded boot and shutdown light shows stored as compact keyframe
+    timelines in flash.
+
+    The sketch prints the flash size and duration of each timeline, then plays
+    the boot show and reports the average and worst CPU time per frame spent
+    in the sequencer (interpolation, without the I2C transfer).
+    A short press plays the shutdown show.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_timeline.h"
+
+#define FRAME_INTERVAL_MS   (10)
+
+// blue fade-in, a white spot running around the ring, settle on green
+const uint8_t bootShow[] PROGMEM =
+{
+  ONOFFBTN_KEYFRAME(600, Easing_EaseOut),   ONOFFBTN_COLOR(9, 0, 0, 180),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(8),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(7),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(1), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(6),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(2), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(5),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(3), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(4),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(4), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(3),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(5), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(2),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(6), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255), ONOFFBTN_KEEP(1),
+  ONOFFBTN_KEYFRAME(100, Easing_Linear),    ONOFFBTN_KEEP(7), ONOFFBTN_COLOR(1, 0, 0, 180), ONOFFBTN_COLOR(1, 255, 255, 255),
+  ONOFFBTN_KEYFRAME(800, Easing_EaseInOut), ONOFFBTN_COLOR(9, 0, 80, 0),
+  ONOFFBTN_TIMELINE_END
+};
+
+// flash red twice, fade out
+const uint8_t shutdownShow[] PROGMEM =
+{
+  ONOFFBTN_KEYFRAME(150, Easing_Step),      ONOFFBTN_COLOR(9, 255, 0, 0),
+  ONOFFBTN_KEYFRAME(150, Easing_Step),      ONOFFBTN_COLOR(9, 0, 0, 0),
+  ONOFFBTN_KEYFRAME(150, Easing_Step),      ONOFFBTN_COLOR(9, 255, 0, 0),
+  ONOFFBTN_KEYFRAME(1500, Easing_EaseIn),   ONOFFBTN_COLOR(9, 0, 0, 0),
+  ONOFFBTN_TIMELINE_END
+};
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_Sequencer sequencer;
+
+// loop status variables
+volatile bool interruptReceived = false;
+unsigned long lastFrame = 0;
+unsigned long cpuTime = 0;
+unsigned long cpuTimeMax = 0;
+unsigned long frames = 0;
+
+void printTimeline(const char *name, const uint8_t *timeline)
+{
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(HHTronik_OnOffBTN_Sequencer::getTimelineSize(timeline));
+  Serial.print(" bytes of flash, ");
+  Serial.print(HHTronik_OnOffBTN_Sequencer::getTimelineDuration(timeline));
+  Serial.println("ms");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+  btn.selectAnimation(PowerOn, Animation_None);
+
+  printTimeline("Boot show", bootShow);
+  printTimeline("Shutdown show", shutdownShow);
+
+  sequencer.play(bootShow, millis());
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+}
+
+void loop()
+{
+  if(interruptReceived)
+  {
+    interruptReceived = false;
+
+    if(btn.getButtonStatus().ShortPress)
+      sequencer.play(shutdownShow, millis());
+  }
+
+  if(!sequencer.isPlaying() || millis() - lastFrame < FRAME_INTERVAL_MS)
+    return;
+
+  lastFrame = millis();
+
+  // time the interpolation alone
+  uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+  unsigned long start = micros();
+  bool playing = sequencer.render(lastFrame, frame);
+  unsigned long elapsed = micros() - start;
+
+  btn.updateFramebuffer(frame);
+
+  cpuTime += elapsed;
+  if(elapsed > cpuTimeMax) cpuTimeMax = elapsed;
+  frames++;
+
+  if(!playing)
+  {
+    Serial.print("Frames: ");
+    Serial.print(frames);
+    Serial.print(", CPU per frame: avg ");
+    Serial.print(cpuTime / frames);
+    Serial.print("us, max ");
+    Serial.print(cpuTimeMax);
+    Serial.println("us");
+
+    cpuTime = cpuTimeMax = frames = 0;
+  }
+}
+
+void handleBtnInterrupt()
+{
+  interruptReceived = true;
+}
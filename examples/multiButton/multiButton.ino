@@ -0,0 +1,78 @@
+/**
+    @file     multiButton.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Run one spinner animation across three ÖnÖffBTNs in lock-step and
+    report the skew between the devices.
+
+    Every second the sketch prints the last and the worst skew, i.e. the time
+    between the first and the last ring receiving its frame.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - give your ÖnÖffBTNs the I2C addresses 0x59, 0x5a and 0x5b
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_group.h"
+
+#define NUM_BUTTONS         (3)
+#define FRAME_INTERVAL_MS   (40)
+
+HHTronik_OnOffBTN buttons[NUM_BUTTONS];
+HHTronik_OnOffBTN_Group group;
+
+uint8_t frames[NUM_BUTTONS][ONOFFBTN_FRAMEBUFFER_SIZE];
+const uint8_t *framePointers[NUM_BUTTONS];
+
+uint8_t position = 0;
+unsigned long lastReport = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  for(uint8_t i = 0; i < NUM_BUTTONS; i++)
+  {
+    buttons[i].begin(ONOFFBTN_DEFAULT_I2C_ADDRESS + i);
+    buttons[i].selectAnimation(PowerOn, Animation_None);
+    buttons[i].clearFramebuffer();
+
+    group.add(buttons[i]);
+    framePointers[i] = frames[i];
+  }
+}
+
+void loop()
+{
+  // one lit pixel travelling over the rings, 27 positions in total
+  memset(frames, 0, sizeof(frames));
+
+  uint8_t device = position / ONOFFBTN_NUM_PIXELS;
+  uint8_t pixel = position % ONOFFBTN_NUM_PIXELS;
+  frames[device][pixel * 3 + 2] = 255;
+
+  position = (position + 1) % (NUM_BUTTONS * ONOFFBTN_NUM_PIXELS);
+
+  group.commit(framePointers);
+
+  if(millis() - lastReport >= 1000)
+  {
+    lastReport = millis();
+
+    Serial.print("Skew: last ");
+    Serial.print(group.getLastSkew());
+    Serial.print("us, max ");
+    Serial.print(group.getMaxSkew());
+    Serial.println("us");
+
+    group.resetSkew();
+  }
+
+  delay(FRAME_INTERVAL_MS);
+}
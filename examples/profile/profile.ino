@@ -0,0 +1,86 @@
+/**
+    @file     profile.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Configure the ÖnÖffBTN from a declarative profile. The configuration is
+    only written (and persisted to EEPROM, which takes ~500ms) when the device
+    doesn't match the profile already, so after the first boot this costs two
+    short burst reads.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+
+// the configuration of our product variant
+constexpr OnOffBTN_ConfigurationProfile variantProfile =
+{
+  .LongPressThreshold = 1000,
+  .HardResetBehavior = {
+    .DisableHardReset = false,
+    .HardResetHoldDuration = 5,
+    .AutoRestartAfterReset = true,
+    .AutoRestartDelay = delay1000ms
+  },
+  .PowerBehavior = {
+    .PoR_DefaultOn = true,
+    .PoR_RestoreFramebuffer = false,
+    .AutoLatchOnOnPress = true,
+    .AutoLatchOnOffPress = false
+  },
+  .OnDelay = 0,
+  .OffDelay = 500,
+  .OnAnimation = Animation_Flash,
+  .OnAnimationSpeed = 100,
+  .OnAnimationConfiguration = 0,
+  .OffAnimation = Animation_Breath,
+  .OffAnimationSpeed = 3,
+  .OffAnimationConfiguration = 0,
+  .RestoreOnFramebuffer = false,
+  .RestoreOffFramebuffer = false,
+  .RTCConfiguration = {
+    .AlarmEnabled = false,
+    .AlarmAction = RTCAlarm_Toggle,
+    .AlarmAutoRearm = false,
+    .UseAmPmFormat = false,
+    .AlarmCancelationDelay = delay1000ms
+  },
+  .AlarmTime = {
+    .Seconds = 0,
+    .Minutes = 0,
+    .Hours = 0,
+    .MaskSeconds = true,
+    .MaskMinutes = true,
+    .MaskHours = true
+  },
+  .AlarmDayDate = {
+    .Value = 0,
+    .IsWeekDayAlarm = false,
+    .DayDateMasked = true
+  }
+};
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+
+void setup()
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  unsigned long start = millis();
+  bool changed = btn.applyProfile(variantProfile);
+
+  Serial.print(changed ? "Configuration updated in " : "Configuration up to date, checked in ");
+  Serial.print(millis() - start);
+  Serial.println("ms");
+}
+
+void loop()
+{
+}
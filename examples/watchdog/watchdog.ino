@@ -0,0 +1,78 @@
+/**
+    @file     watchdog.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Watchdog example for the ÖnÖffBTN with an Arduino.
+
+    The ÖnÖffBTN RTC is used as an external watchdog: the loop kicks it on
+    every iteration, and if the Arduino stops doing so for 10 seconds the
+    ÖnÖffBTN power-cycles it.
+
+    Click the button ("Short press") to simulate a hang: the sketch stops
+    kicking the watchdog and gets reset 10 seconds later.
+
+    How-to (for an Arduino UNO):
+
+    - program your Arduino with this sketch
+    - connect the power supply of your Arduino to the power-output of the ÖnÖffBTN
+    - connect the I2C bus (I2C_SDA to A4, I2C_SCL to A5)
+    - connect the INT pin to Pin2
+
+    Visit https://hhtronik.com for more information
+*/
+
+
+#include "hhtronik_onoffbtn.h"
+#include "hhtronik_onoffbtn_watchdog.h"
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+HHTronik_OnOffBTN_Watchdog watchdog = HHTronik_OnOffBTN_Watchdog(btn);
+OnOffBTN_StatusRegister status;
+
+// loop status variables
+bool interruptReceived = false;
+
+void setup() 
+{
+  Serial.begin(115200);
+  btn.begin();
+
+  // the first time this waits ~500ms for the RTC configuration to commit,
+  // after a reset by the watchdog the RTC is already configured
+  if(!watchdog.arm(10))
+    Serial.println("Watchdog: couldn't read the RTC");
+  else
+    Serial.println("Watchdog: armed (10s)");
+
+  // Pin 2 for INT
+  pinMode(2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(2), handleBtnInterrupt, RISING);  // wait for the rising edge...
+}
+
+void loop() 
+{
+  // this is cheap: the bus is only used once per second
+  watchdog.kick();
+
+  if(interruptReceived)
+  {
+    interruptReceived = false;
+    status = btn.getButtonStatus();
+
+    if(status.ShortPress) 
+    {
+      Serial.println("Button: short press, hanging...");
+
+      while(1)
+      {
+        // no more kicks, the ÖnÖffBTN will reset us
+      }
+    }
+  }
+}
+
+void handleBtnInterrupt() 
+{
+  interruptReceived = true;
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Flash/RAM cost of each feature unit of the ÖnÖffBTN driver.
+#
+# Builds extras/footprint/footprint.ino with arduino-cli, first with the core
+# only, then with each unit enabled on its own and finally with everything,
+# and prints the difference to the core-only build.
+#
+# usage: extras/footprint.sh [fqbn]     (default: arduino:avr:uno)
+#
+
+FQBN=${1:-arduino:avr:uno}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+SKETCH="$ROOT/extras/footprint"
+UNITS="FRAMEBUFFER ANIMATION USER_EEPROM RTC"
+
+# build with the given units enabled, print "<flash> <ram>"
+build() {
+    flags=""
+    for unit in $UNITS; do
+        value=0
+        for enabled in $1; do
+            [ "$unit" = "$enabled" ] && value=1
+        done
+        flags="$flags -DONOFFBTN_ENABLE_$unit=$value"
+    done
+
+    output=$(arduino-cli compile --fqbn "$FQBN" --library "$ROOT" \
+        --build-property "compiler.cpp.extra_flags=$flags" "$SKETCH" 2>&1) || {
+        echo "$output" >&2
+        exit 1
+    }
+
+    flash=$(echo "$output" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+    ram=$(echo "$output" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+    echo "$flash ${ram:-0}"
+}
+
+result=$(build "") || exit 1
+set -- $result
+CORE_FLASH=$1
+CORE_RAM=$2
+
+echo "board: $FQBN"
+printf "%-14s %8s %8s\n" "unit" "flash" "ram"
+printf "%-14s %8s %8s\n" "core" "$CORE_FLASH" "$CORE_RAM"
+
+for unit in $UNITS "$UNITS"; do
+    result=$(build "$unit") || exit 1
+    set -- $result
+    [ "$unit" = "$UNITS" ] && unit="all"
+    printf "%-14s %+8d %+8d\n" "$unit" $(($1 - CORE_FLASH)) $(($2 - CORE_RAM))
+done
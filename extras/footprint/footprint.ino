@@ -0,0 +1,63 @@
+/**
+    @file     footprint.ino
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Reference sketch for extras/footprint.sh: uses every feature unit that is
+    enabled in the build, so the linker keeps it and the size difference
+    between two builds is the cost of the unit.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#include "hhtronik_onoffbtn.h"
+
+HHTronik_OnOffBTN btn = HHTronik_OnOffBTN();
+volatile uint8_t sink;
+
+void setup()
+{
+  btn.begin();
+
+  // core
+  sink = btn.getRawButtonStatus();
+  btn.setLongPressThreshold(btn.getLongPressThreshold());
+  btn.setOnDelay(btn.getOnDelay());
+  btn.setPowerBehaviorConfiguration(btn.getPowerOnResetConfiguration());
+  btn.setHardResetBehaviorConfiguration(btn.getHardResetBehaviorConfiguration());
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+  uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE] = { 0 };
+  btn.clearFramebuffer();
+  btn.setPixel(0, 255, 0, 0);
+  btn.setPixels(frame, sizeof(frame));
+  sink = btn.updateFramebuffer(frame);
+  sink = btn.readFramebuffer(frame);
+#endif
+
+#if ONOFFBTN_ENABLE_ANIMATION
+  btn.selectAnimation(PowerOn, btn.getSelectedAnimation(PowerOff));
+  btn.setAnimationSpeed(PowerOn, btn.getAnimationSpeed(PowerOff));
+  btn.setAnimationConfiguration(PowerOn, btn.getAnimationConfiguration(PowerOff));
+  btn.saveAnimationFramebuffer(PowerOn);
+  btn.restoreStoredAnimationFramebuffer(PowerOn);
+  btn.setFramebufferRestoreBehavior(true, false);
+#endif
+
+#if ONOFFBTN_ENABLE_USER_EEPROM
+  uint8_t eeprom[ONOFFBTN_USER_EEPROM_SIZE];
+  sink = btn.readUserEEPROM(0, eeprom, sizeof(eeprom));
+  sink = btn.writeUserEEPROM(0, eeprom, sizeof(eeprom));
+#endif
+
+#if ONOFFBTN_ENABLE_RTC
+  btn.setRTCConfiguration(btn.getRTCConfiguration());
+  btn.setDateTime(btn.getDateTime());
+  btn.setAlarmTime(btn.getAlarmTime());
+  btn.setAlarmDayDate(btn.getAlarmDayDate());
+#endif
+}
+
+void loop()
+{
+}
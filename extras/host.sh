@@ -0,0 +1,36 @@
+#!/bin/sh
+#
+# Host checks of the ÖnÖffBTN driver.
+#
+# Builds the driver with g++ against the simulated device of extras/host
+# (fake Arduino core and Wire, see fake_device.h), then runs every
+# extras/host/*_test.cpp and, with --bench, every extras/host/*_bench.cpp.
+#
+# usage: extras/host.sh [--bench]      (CXX and CXXFLAGS are honored)
+#
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=gnu++11 -O2 -Wall -Wno-narrowing}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+HOST="$ROOT/extras/host"
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+PROGRAMS="$HOST/*_test.cpp"
+[ "$1" = "--bench" ] && PROGRAMS="$PROGRAMS $HOST/*_bench.cpp"
+
+failed=0
+
+for program in $PROGRAMS; do
+    name=$(basename "$program" .cpp)
+
+    $CXX $CXXFLAGS -pthread -DARDUINO=10800 -I"$HOST" -I"$ROOT" -o "$OUT/$name" \
+        "$ROOT"/*.cpp "$HOST/fake_device.cpp" "$program" || {
+        failed=1
+        continue
+    }
+
+    "$OUT/$name" || failed=1
+done
+
+exit $failed
@@ -0,0 +1,36 @@
+/**
+    @file     Arduino.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Minimal Arduino core for building the ÖnÖffBTN driver on a host (see
+    extras/host.sh). Time is virtual: it only advances with delay() and
+    with the transfers on the fake bus (see fake_device.h).
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_HOST_ARDUINO_H_
+#define _HHTRONIK_ONOFFBTN_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ARDUINO_HOST
+
+#define PROGMEM
+#define pgm_read_byte(address)      (*(const uint8_t *)(address))
+#define pgm_read_word(address)      (*(const uint16_t *)(address))
+
+typedef bool boolean;
+
+unsigned long millis( void );
+unsigned long micros( void );
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+inline void noInterrupts( void ) {}
+inline void interrupts( void ) {}
+
+#endif
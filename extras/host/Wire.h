@@ -0,0 +1,44 @@
+/**
+    @file     Wire.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Wire for host builds: the transfers go to the simulated ÖnÖffBTN of
+    fake_device.h.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_HOST_WIRE_H_
+#define _HHTRONIK_ONOFFBTN_HOST_WIRE_H_
+
+#include "Arduino.h"
+
+class TwoWire {
+ public:
+  void begin( void ) {}
+  void begin(int sda, int scl) { (void)sda; (void)scl; }
+  void setClock(uint32_t clock);
+
+  void beginTransmission(uint8_t addr);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *buffer, size_t length);
+  uint8_t endTransmission(bool stop = true);
+
+  uint8_t requestFrom(uint8_t addr, uint8_t length, uint8_t stop = true);
+  int available( void ) { return _rxLength - _rxIndex; }
+  int read( void ) { return _rxIndex < _rxLength ? _rx[_rxIndex++] : -1; }
+  void flush( void ) {}
+
+ private:
+  uint8_t _addr;
+  uint8_t _tx[64];
+  uint8_t _txLength;
+  uint8_t _rx[64];
+  uint8_t _rxLength;
+  uint8_t _rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,95 @@
+/**
+    @file     busclock_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Bus clock: step down on errors and back up once the bus is fine again,
+    one clock for every instance, negotiation on a marginal bus.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+#include "host_test.h"
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+    HHTronik_OnOffBTN other;
+
+    fakeDevice_reset();
+    btn.begin();
+    CHECK(fakeDevice.Clock == ONOFFBTN_BUS_CLOCK_DEFAULT);
+
+    btn.setBusClock(1000000);
+    CHECK(fakeDevice.Clock == 1000000);
+
+    // failed transfers in a row (a read is two bus operations): one step down
+    fakeDevice.FailOperations = ONOFFBTN_BUS_ERROR_LIMIT * 2;
+    for(uint8_t i = 0; i < ONOFFBTN_BUS_ERROR_LIMIT; i++) btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 400000);
+    CHECK(fakeDevice.Clock == 400000);
+    CHECK(btn.getBusErrorCount() == ONOFFBTN_BUS_ERROR_LIMIT);
+
+    // the clock is the bus', every instance sees it and begin() keeps it
+    CHECK(other.getBusClock() == 400000);
+    other.begin(0x5a);
+    CHECK(fakeDevice.Clock == 400000);
+    CHECK(other.getBusErrorCount() == 0);
+
+    // errors that aren't in a row don't step down
+    for(uint8_t i = 0; i < 10; i++)
+    {
+        fakeDevice.FailOperations = (ONOFFBTN_BUS_ERROR_LIMIT - 1) * 2;
+        for(uint8_t j = 0; j < ONOFFBTN_BUS_ERROR_LIMIT; j++) btn.getRawButtonStatus();
+    }
+    CHECK(btn.getBusClock() == 400000);
+
+    // good transfers (the last read above was one): back up to the clock
+    // that was set, not beyond
+    for(uint16_t i = 0; i < ONOFFBTN_BUS_RECOVERY_LIMIT - 2; i++) btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 400000);
+    btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 1000000);
+    CHECK(fakeDevice.Clock == 1000000);
+
+    for(uint16_t i = 0; i < ONOFFBTN_BUS_RECOVERY_LIMIT; i++) btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 1000000);
+
+    // two steps down, and up one step at a time towards 400kHz
+    btn.setBusClock(400000);
+    fakeDevice.FailOperations = ONOFFBTN_BUS_ERROR_LIMIT * 2;
+    for(uint8_t i = 0; i < ONOFFBTN_BUS_ERROR_LIMIT; i++) btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 100000);
+
+    for(uint16_t i = 0; i < ONOFFBTN_BUS_RECOVERY_LIMIT * 3; i++) btn.getRawButtonStatus();
+    CHECK(btn.getBusClock() == 400000);
+
+    // a marginal bus: at 1MHz bit 0 doesn't rise in time. The configuration
+    // and the User-EEPROM are all zeros, only a written pattern shows it.
+    fakeDevice_reset();
+    btn.begin();
+    btn.resetBusErrorCount();
+    fakeDevice.MarginalClock = 400000;
+    fakeDevice.MarginalMask = 0x01;
+
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++) frame[i] = 0x80 | (i << 1);
+    memcpy(fakeDevice.Registers + 0xd0, frame, sizeof(frame));
+
+    CHECK(btn.negotiateBusClock() == 400000);
+    CHECK(fakeDevice.Clock == 400000);
+    CHECK(btn.getBusErrorCount() == 0);
+    CHECK(memcmp(fakeDevice.Registers + 0xd0, frame, sizeof(frame)) == 0);     // restored
+
+    // a clean bus
+    fakeDevice.MarginalClock = 0;
+    CHECK(btn.negotiateBusClock() == 1000000);
+    CHECK(btn.negotiateBusClock(400000) == 400000);
+    CHECK(memcmp(fakeDevice.Registers + 0xd0, frame, sizeof(frame)) == 0);
+
+    // nothing answers
+    fakeDevice.Address = 0x5a;
+    CHECK(btn.negotiateBusClock() == 100000);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,83 @@
+/**
+    @file     busowner_bench.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Field update throughput of the bus owner against a driver guarded by a
+    plain std::mutex, with N producer threads. Every producer updates one
+    field of the power behavior register and waits for each of its updates, the
+    simulated device spends the real transfer time at 400kHz. The register
+    has four fields, producers beyond four share them.
+
+    Run with extras/host.sh --bench
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_busowner.h"
+#include "fake_device.h"
+
+#include <stdio.h>
+#include <chrono>
+
+#define UPDATES     (2000)      // per producer
+
+template<typename Update>
+static double
+run(uint8_t producers, Update update)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for(uint8_t t = 0; t < producers; t++)
+    {
+        threads.push_back(std::thread([&update, t]()
+        {
+            for(int i = 0; i < UPDATES; i++) update(1 << (t & 3), (i & 1) ? 0 : 0xff);
+        }));
+    }
+
+    for(std::thread &thread : threads) thread.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return producers * UPDATES / elapsed.count();
+}
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+    fakeDevice.RealTime = true;
+
+    printf("producers   mutex [updates/s]   writes   bus owner [updates/s]   writes   merged\n");
+
+    for(uint8_t producers = 1; producers <= 8; producers *= 2)
+    {
+        std::mutex lock;
+        uint32_t writes = fakeDevice.Writes;
+
+        // what an application does without the bus owner: read, change the
+        // field, write back, all under one lock
+        double locked = run(producers, [&btn, &lock](uint8_t mask, uint8_t value)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            uint8_t current = OnOffBTN_encodePowerBehavior(btn.getPowerOnResetConfiguration());
+            btn.setPowerBehaviorConfiguration(OnOffBTN_decodePowerBehavior((current & ~mask) | (value & mask)));
+        });
+
+        uint32_t lockedWrites = fakeDevice.Writes - writes;
+        writes = fakeDevice.Writes;
+
+        HHTronik_OnOffBTN_BusOwner owner(btn);
+        double owned = run(producers, [&owner](uint8_t mask, uint8_t value)
+        {
+            owner.updateField(0x05, mask, value).get();
+        });
+
+        printf("%9u   %19.0f   %6u   %21.0f   %6u   %6u\n", producers, locked, lockedWrites,
+            owned, (unsigned)(fakeDevice.Writes - writes), owner.getMergedCount());
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+    @file     busowner_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Bus owner: field updates from several threads are merged, a failed read
+    never turns into a write.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_busowner.h"
+#include "host_test.h"
+
+#include <stdexcept>
+
+#define THREADS     (4)
+#define UPDATES     (200)
+
+static bool
+fails(std::future<void> &done)
+{
+    try
+    {
+        done.get();
+    }
+    catch(const std::runtime_error &)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    // every thread owns one bit of 0x05, the other bits stay as they are
+    {
+        HHTronik_OnOffBTN_BusOwner owner(btn);
+        fakeDevice.Registers[0x05] = 0xf0;
+
+        std::vector<std::thread> threads;
+        for(uint8_t t = 0; t < THREADS; t++)
+        {
+            threads.push_back(std::thread([&owner, t]()
+            {
+                for(int i = 0; i < UPDATES; i++)
+                {
+                    std::future<void> done = owner.updateField(0x05, 1 << t, (i & 1) ? 0 : 0xff);
+                    if(i == UPDATES - 1) done.get();
+                }
+            }));
+        }
+
+        for(std::thread &thread : threads) thread.join();
+
+        // UPDATES is even: every thread's last update cleared its bit
+        std::future<uint8_t> value = owner.submit([](HHTronik_OnOffBTN &) { return fakeDevice.Registers[0x05]; });
+        CHECK(value.get() == 0xf0);
+    }
+
+    // the read NACKs: the register must not be written with a guessed value
+    {
+        HHTronik_OnOffBTN_BusOwner owner(btn);
+        fakeDevice.Registers[0x05] = 0x01;
+        fakeDevice.FailOperations = 1;
+
+        uint32_t writes = fakeDevice.Writes;
+        std::future<void> done = owner.updateField(0x05, 0x02, 0x02);
+
+        CHECK(fails(done));
+        CHECK(fakeDevice.Writes == writes);
+        CHECK(fakeDevice.Registers[0x05] == 0x01);
+
+        // the bus is back
+        done = owner.updateField(0x05, 0x02, 0x02);
+        CHECK(!fails(done));
+        CHECK(fakeDevice.Registers[0x05] == 0x03);
+    }
+
+    // the write NACKs (whole register updates don't read)
+    {
+        HHTronik_OnOffBTN_BusOwner owner(btn);
+        fakeDevice.Registers[0x05] = 0x01;
+        fakeDevice.FailOperations = 1;
+
+        std::future<void> done = owner.updateField(0x05, 0xff, 0x42);
+        CHECK(fails(done));
+        CHECK(fakeDevice.Registers[0x05] == 0x01);
+    }
+
+    return TEST_RESULT();
+}
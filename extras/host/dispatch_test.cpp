@@ -0,0 +1,92 @@
+/**
+    @file     dispatch_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Event dispatcher: every flagged event is dispatched once, PowerOn only
+    on its edges.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_dispatch.h"
+#include "host_test.h"
+
+static uint8_t calls[6];
+static uint8_t lastStatus;
+
+template<uint8_t Event>
+static void
+handler(uint8_t status)
+{
+    calls[Event]++;
+    lastStatus = status;
+}
+
+static HHTronik_OnOffBTN_Dispatcher<handler<0>, handler<1>, handler<2>, handler<3>, handler<4>, handler<5> > dispatcher;
+
+// only ShortPress and the alarm are bound
+static HHTronik_OnOffBTN_Dispatcher<OnOffBTN_IgnoreEvent, handler<1>, OnOffBTN_IgnoreEvent,
+    OnOffBTN_IgnoreEvent, OnOffBTN_IgnoreEvent, handler<5> > partial;
+
+/**
+ * dispatch status and check that exactly the handlers in expected were
+ * called, once each
+ */
+static bool
+dispatched(uint8_t status, uint8_t expected)
+{
+    memset(calls, 0, sizeof(calls));
+    dispatcher.dispatch(status);
+
+    for(uint8_t event = 0; event < 6; event++)
+    {
+        if(calls[event] != ((expected >> event) & 1)) return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    // each event bit on its own
+    CHECK(dispatched(ONOFFBTN_STATUS_DOWN, ONOFFBTN_STATUS_DOWN));
+    CHECK(dispatched(ONOFFBTN_STATUS_SHORTPRESS, ONOFFBTN_STATUS_SHORTPRESS));
+    CHECK(dispatched(ONOFFBTN_STATUS_LONGPRESS, ONOFFBTN_STATUS_LONGPRESS));
+    CHECK(dispatched(ONOFFBTN_STATUS_DOUBLECLICK, ONOFFBTN_STATUS_DOUBLECLICK));
+    CHECK(dispatched(ONOFFBTN_STATUS_RTCALARM, ONOFFBTN_STATUS_RTCALARM));
+    CHECK(dispatched(0, 0));
+
+    // every bit at once: each handler once, with the whole status
+    uint8_t events = ONOFFBTN_STATUS_DOWN | ONOFFBTN_STATUS_SHORTPRESS | ONOFFBTN_STATUS_LONGPRESS
+                   | ONOFFBTN_STATUS_DOUBLECLICK | ONOFFBTN_STATUS_RTCALARM;
+    CHECK(dispatched(events, events));
+    CHECK(lastStatus == events);
+
+    // PowerOn is a state: the handler runs on its edges only
+    CHECK(dispatched(ONOFFBTN_STATUS_POWERON, ONOFFBTN_STATUS_POWERON));     // off -> on
+    CHECK(dispatched(ONOFFBTN_STATUS_POWERON, 0));
+    CHECK(dispatched(ONOFFBTN_STATUS_POWERON | ONOFFBTN_STATUS_SHORTPRESS, ONOFFBTN_STATUS_SHORTPRESS));
+    CHECK(dispatched(0, ONOFFBTN_STATUS_POWERON));                          // on -> off
+    CHECK(lastStatus == 0);
+    CHECK(dispatched(0, 0));
+    CHECK(dispatched(ONOFFBTN_STATUS_POWERON | events, ONOFFBTN_STATUS_POWERON | events));
+
+    // unbound events call nothing
+    memset(calls, 0, sizeof(calls));
+    partial.dispatch((uint8_t)(events | ONOFFBTN_STATUS_POWERON));
+    CHECK(calls[0] == 0 && calls[1] == 1 && calls[2] == 0 && calls[3] == 0 && calls[4] == 0 && calls[5] == 1);
+
+    // read from the device
+    HHTronik_OnOffBTN btn;
+    HHTronik_OnOffBTN_Dispatcher<handler<0>, handler<1>, handler<2>, handler<3>, handler<4>, handler<5> > reader;
+
+    fakeDevice_reset();
+    btn.begin();
+    fakeDevice.Registers[0x00] = ONOFFBTN_STATUS_POWERON | ONOFFBTN_STATUS_LONGPRESS;
+
+    memset(calls, 0, sizeof(calls));
+    CHECK(reader.dispatch(btn) == (ONOFFBTN_STATUS_POWERON | ONOFFBTN_STATUS_LONGPRESS));
+    CHECK(calls[2] == 1 && calls[4] == 1 && calls[0] + calls[1] + calls[3] + calls[5] == 0);
+
+    return TEST_RESULT();
+}
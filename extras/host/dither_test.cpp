@@ -0,0 +1,93 @@
+/**
+    @file     dither_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Temporal dithering: the error carried from frame to frame stays below
+    one 8 bit step and the frames average out to the 16 bit value.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_dither.h"
+#include "host_test.h"
+
+#define FRAMES      (256)       // a whole period of the low byte
+
+static uint32_t random_state = 1;
+
+// xorshift32, a fixed series
+static uint32_t
+nextRandom( void )
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+int main()
+{
+    HHTronik_OnOffBTN_Dither dither;
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+    uint32_t sum[ONOFFBTN_FRAMEBUFFER_SIZE];
+    uint16_t target[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    // edge values and random ones
+    static const uint16_t edges[] = { 0, 1, 0x7f, 0x80, 0xff, 0x100, 0x101, 0x1ff, 0x7fff, 0xfeff, 0xff00, 0xff01, 0xffff };
+
+    for(uint8_t round = 0; round < 20; round++)
+    {
+        for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+        {
+            uint32_t pick = nextRandom();
+            target[i] = (pick & 1) ? edges[(pick >> 1) % (sizeof(edges) / sizeof(edges[0]))] : (uint16_t)(pick >> 16);
+            dither.getFramebuffer()[i] = target[i];
+            sum[i] = 0;
+        }
+
+        dither.reset();
+        bool bounded = true;
+
+        for(uint16_t n = 1; n <= FRAMES; n++)
+        {
+            dither.render(frame);
+
+            for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+            {
+                // 255 is as bright as it gets
+                uint32_t reachable = target[i] > 0xff00 ? 0xff00 : target[i];
+
+                sum[i] += frame[i];
+
+                // what's owed after n frames, in 1/256 steps: never a whole step
+                int32_t owed = (int32_t)(n * reachable) - (int32_t)(sum[i] * 256);
+                if(owed < 0 || owed >= 256) bounded = false;
+            }
+        }
+
+        CHECK(bounded);
+
+        // over a whole period the average is exact
+        for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+            CHECK(sum[i] == (target[i] > 0xff00 ? 0xff00 : target[i]));
+    }
+
+    // show(): the device gets the rendered frames, only toggling subpixels are sent
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    memset(dither.getFramebuffer(), 0, ONOFFBTN_FRAMEBUFFER_SIZE * sizeof(uint16_t));
+    dither.setPixel(0, 0x0180, 0x0100, 0);      // 1.5 and 1
+    dither.reset();
+
+    dither.show(btn);
+    CHECK(fakeDevice.Registers[0xd0] == 1 && fakeDevice.Registers[0xd1] == 1);
+    CHECK(dither.show(btn) == 1);
+    CHECK(fakeDevice.Registers[0xd0] == 2 && fakeDevice.Registers[0xd1] == 1);
+    CHECK(dither.show(btn) == 1);
+    CHECK(fakeDevice.Registers[0xd0] == 1);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+/**
+    @file     fake_device.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Simulated ÖnÖffBTN for host builds.
+
+    Visit https://hhtronik.com for more information
+*/
+#include <chrono>
+#include "Wire.h"
+#include "fake_device.h"
+
+OnOffBTN_FakeDevice fakeDevice;
+TwoWire Wire;
+
+static uint64_t virtualMicros = 0;
+static uint8_t pointer = 0;
+
+/////////////////////////////////////////////////////////
+// Private:
+
+// START, address, bytes with their ACKs and STOP
+static void
+transferTime(uint8_t bytes)
+{
+    uint32_t clock = fakeDevice.Clock ? fakeDevice.Clock : 100000;
+    uint32_t us = ((bytes + 1) * 9 + 2) * 1000000UL / clock;
+
+    virtualMicros += us;
+
+    if(fakeDevice.RealTime)
+    {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+        while(std::chrono::steady_clock::now() < end);
+    }
+
+    if(fakeDevice.OnTransfer) fakeDevice.OnTransfer();
+}
+
+static uint8_t
+marginal(uint8_t value)
+{
+    if(fakeDevice.MarginalClock && fakeDevice.Clock > fakeDevice.MarginalClock)
+        return value & ~fakeDevice.MarginalMask;
+
+    return value;
+}
+
+static bool
+fail( void )
+{
+    fakeDevice.Operations++;
+    if(fakeDevice.FailOperations == 0) return false;
+
+    fakeDevice.FailOperations--;
+    return true;
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void
+fakeDevice_reset( void )
+{
+    memset(&fakeDevice, 0, sizeof(fakeDevice));
+    fakeDevice.Address = 0x59;
+    fakeDevice.WriteLimit = 0xff;
+    fakeDevice.Clock = 100000;
+    pointer = 0;
+}
+
+void
+fakeDevice_advance(uint32_t us)
+{
+    virtualMicros += us;
+}
+
+unsigned long millis( void ) { return (unsigned long)(virtualMicros / 1000); }
+unsigned long micros( void ) { return (unsigned long)virtualMicros; }
+void delay(unsigned long ms) { virtualMicros += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { virtualMicros += us; }
+
+/////////////////////////////////////////////////////////
+// Wire:
+
+void
+TwoWire::setClock(uint32_t clock)
+{
+    fakeDevice.Clock = clock;
+}
+
+void
+TwoWire::beginTransmission(uint8_t addr)
+{
+    _addr = addr;
+    _txLength = 0;
+}
+
+size_t
+TwoWire::write(uint8_t value)
+{
+    if(_txLength >= sizeof(_tx)) return 0;
+
+    _tx[_txLength++] = value;
+    return 1;
+}
+
+size_t
+TwoWire::write(const uint8_t *buffer, size_t length)
+{
+    size_t written = 0;
+    while(written < length && write(buffer[written])) written++;
+    return written;
+}
+
+uint8_t
+TwoWire::endTransmission(bool stop)
+{
+    (void)stop;
+    transferTime(_txLength);
+
+    if(_addr != fakeDevice.Address) { fakeDevice.Operations++; return 2; }      // address NACK
+    if(fail()) return 2;
+    if(_txLength == 0) return 0;
+
+    pointer = _tx[0];
+
+    uint8_t length = _txLength - 1;
+    if(length == 0) return 0;
+
+    bool interrupted = fakeDevice.WriteLimit < length;
+    if(interrupted) length = fakeDevice.WriteLimit;
+    fakeDevice.WriteLimit = 0xff;
+
+    for(uint8_t i = 0; i < length; i++)
+        fakeDevice.Registers[pointer++] = marginal(_tx[1 + i]);
+
+    fakeDevice.BytesWritten += length;
+    fakeDevice.Writes++;
+
+    if(fakeDevice.LogLength == FAKE_DEVICE_LOG_SIZE)
+    {
+        memmove(fakeDevice.Log, fakeDevice.Log + 1, sizeof(fakeDevice.Log) - sizeof(fakeDevice.Log[0]));
+        fakeDevice.LogLength--;
+    }
+
+    fakeDevice.Log[fakeDevice.LogLength].Register = _tx[0];
+    fakeDevice.Log[fakeDevice.LogLength].Length = length;
+    fakeDevice.Log[fakeDevice.LogLength].Time = (uint32_t)virtualMicros;
+    fakeDevice.LogLength++;
+
+    return interrupted ? 4 : 0;
+}
+
+uint8_t
+TwoWire::requestFrom(uint8_t addr, uint8_t length, uint8_t stop)
+{
+    (void)stop;
+    transferTime(length);
+
+    _rxLength = 0;
+    _rxIndex = 0;
+
+    if(addr != fakeDevice.Address) { fakeDevice.Operations++; return 0; }
+    if(fail()) return 0;
+    if(length > sizeof(_rx)) length = sizeof(_rx);
+
+    for(uint8_t i = 0; i < length; i++)
+        _rx[i] = marginal(fakeDevice.Registers[pointer++]);
+
+    _rxLength = length;
+    return length;
+}
@@ -0,0 +1,62 @@
+/**
+    @file     fake_device.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Simulated ÖnÖffBTN for host builds: a register file behind the fake
+    Wire, with counters and fault injection. It models the bus framing
+    (register pointer, auto-increment, NACKs, interrupted writes), not the
+    device's firmware: commands written to 0x01/0x10 aren't executed.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_HOST_FAKE_DEVICE_H_
+#define _HHTRONIK_ONOFFBTN_HOST_FAKE_DEVICE_H_
+
+#include "Arduino.h"
+
+#define FAKE_DEVICE_LOG_SIZE    (64)
+
+typedef struct
+{
+  uint8_t Register;
+  uint8_t Length;
+  uint32_t Time;            // us, end of the transfer
+} FakeDevice_Write;
+
+typedef struct
+{
+  uint8_t Registers[256];
+  uint8_t Address;
+
+  uint16_t FailOperations;  // the next n bus operations (write or read) NACK
+  uint8_t WriteLimit;       // bytes of the next write that arrive before it's interrupted (0xff: all)
+  bool RealTime;            // spend the transfer time for real too (benchmarks)
+  void (*OnTransfer)(void); // called once the time of each bus operation has passed (interrupts)
+
+  uint32_t MarginalClock;   // above this clock the lines don't rise in time:
+  uint8_t MarginalMask;     // these bits of every data byte transfer as 0
+
+  uint32_t Clock;
+  uint32_t Operations;      // completed or failed bus operations
+  uint32_t BytesWritten;    // register bytes that arrived
+  uint32_t Writes;          // write operations with data
+
+  FakeDevice_Write Log[FAKE_DEVICE_LOG_SIZE];   // the last writes with data, oldest first
+  uint8_t LogLength;
+} OnOffBTN_FakeDevice;
+
+extern OnOffBTN_FakeDevice fakeDevice;
+
+/**
+ * Zero the registers, counters and faults (the virtual time keeps going)
+ */
+void fakeDevice_reset( void );
+
+/**
+ * Advance the virtual time
+ */
+void fakeDevice_advance(uint32_t us);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+    @file     framebuffer_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Framebuffer copy: a NACKed transfer must not leave a copy that differs
+    from the device, or the diff never sends the lost subpixels.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+#include "host_test.h"
+
+#define FRAMEBUFFER (fakeDevice.Registers + 0xd0)
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    fakeDevice_reset();
+    btn.begin();
+
+    memset(frame, 0, sizeof(frame));
+    CHECK(btn.updateFramebuffer(frame) == 0);      // read back, nothing differs
+
+    // a single subpixel changes and the update NACKs
+    frame[5] = 0x80;
+    fakeDevice.FailOperations = 1;
+    btn.updateFramebuffer(frame);
+    CHECK(FRAMEBUFFER[5] == 0);
+
+    // the next update resynchronizes and sends it
+    CHECK(btn.updateFramebuffer(frame) == 1);
+    CHECK(FRAMEBUFFER[5] == 0x80);
+
+    // interrupted after the first byte of a burst
+    frame[6] = 0x11;
+    frame[7] = 0x22;
+    fakeDevice.WriteLimit = 1;
+    btn.updateFramebuffer(frame);
+    btn.updateFramebuffer(frame);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    // the same for the other writers
+    fakeDevice.FailOperations = 1;
+    btn.setPixel(2, 1, 2, 3);
+    frame[6] = 1; frame[7] = 2; frame[8] = 3;
+    btn.updateFramebuffer(frame);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    fakeDevice.FailOperations = 1;
+    btn.setPixels(frame + 9, 3, 9);
+    frame[9] = 0x44;
+    btn.updateFramebuffer(frame);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    fakeDevice.FailOperations = 1;
+    btn.clearFramebuffer();
+    memset(frame, 0, sizeof(frame));
+    btn.updateFramebuffer(frame);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    // read back fails as well: everything is sent, the copy is only trusted
+    // once that worked
+    btn.invalidateFramebuffer();
+    frame[0] = 0x55;
+    fakeDevice.FailOperations = 3;     // both read operations and the write
+    CHECK(btn.updateFramebuffer(frame) == ONOFFBTN_FRAMEBUFFER_SIZE);
+    CHECK(FRAMEBUFFER[0] == 0);
+    btn.updateFramebuffer(frame);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    return TEST_RESULT();
+}
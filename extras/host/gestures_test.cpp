@@ -0,0 +1,121 @@
+/**
+    @file     gestures_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Gesture recognizer: clicks, holds and press/release edges that come in
+    the same status read, the longest hold reported while still down.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_gestures.h"
+#include "host_test.h"
+
+static OnOffBTN_StatusRegister
+status(bool down, bool shortPress, bool longPress = false)
+{
+    OnOffBTN_StatusRegister s = OnOffBTN_StatusRegister();
+    s.Down = down;
+    s.ShortPress = shortPress;
+    s.LongPress = longPress;
+    return s;
+}
+
+int main()
+{
+    // three clicks, press and release reported by the same read each time:
+    // the single click must not end the sequence
+    {
+        const OnOffBTN_Gesture gestures[] = { { 1, 0 }, { 3, 0 } };
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 2);
+
+        CHECK(recognizer.feed(status(true, true), 1000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(true, true), 1150) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(true, true), 1300) == 1);
+        CHECK(recognizer.update(2000) == ONOFFBTN_NO_GESTURE);
+    }
+
+    // a single same-read click ends with the timeout
+    {
+        const OnOffBTN_Gesture gestures[] = { { 1, 0 }, { 3, 0 } };
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 2);
+
+        CHECK(recognizer.feed(status(true, true), 1000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(1000 + ONOFFBTN_GESTURE_CLICK_TIMEOUT - 1) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(1000 + ONOFFBTN_GESTURE_CLICK_TIMEOUT) == 0);
+    }
+
+    // same-read clicks with nothing longer in the table end at once
+    {
+        const OnOffBTN_Gesture gestures[] = { { 1, 0 }, { 1, 1000 } };
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 2);
+
+        CHECK(recognizer.feed(status(true, true), 1000) == 0);
+    }
+
+    // separate press and release edges: hold thresholds, longest reached wins
+    {
+        const OnOffBTN_Gesture gestures[] = { { 1, 0 }, { 1, 1000 }, { 1, 3000 }, { 2, 1000 } };
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 4);
+
+        CHECK(recognizer.feed(status(true, false), 1000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, false, true), 2500) == 1);
+
+        CHECK(recognizer.feed(status(true, false), 5000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, false, true), 8500) == 2);
+
+        // click, then press and hold
+        CHECK(recognizer.feed(status(true, false), 10000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, true), 10100) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(true, false), 10300) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, false, true), 11400) == 3);
+
+        // short click, below every hold threshold
+        CHECK(recognizer.feed(status(true, false), 20000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, true), 20100) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(20100 + ONOFFBTN_GESTURE_CLICK_TIMEOUT) == 0);
+    }
+
+    // the longest hold is reported once its threshold passes, the release
+    // that follows is no gesture
+    {
+        const OnOffBTN_Gesture gestures[] = { { 1, 0 }, { 1, 1000 }, { 1, 3000 } };
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 3);
+
+        CHECK(recognizer.feed(status(true, false), 1000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(2500) == ONOFFBTN_NO_GESTURE);     // a longer hold may follow
+        CHECK(recognizer.update(3999) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(4000) == 2);
+        CHECK(recognizer.update(5000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(true, false), 6000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, false, true), 9000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(20000) == ONOFFBTN_NO_GESTURE);
+
+        // shorter holds still end on release
+        CHECK(recognizer.feed(status(true, false), 30000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(31500) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.feed(status(false, false, true), 31500) == 1);
+    }
+
+    // indices have to fit the int8_t results: the table is cut at
+    // ONOFFBTN_GESTURE_MAX_COUNT entries
+    {
+        OnOffBTN_Gesture gestures[200];
+        for(uint8_t i = 0; i < 200; i++)
+        {
+            gestures[i].Presses = 10;
+            gestures[i].HoldTime = 0;
+        }
+
+        gestures[150].Presses = 1;
+        HHTronik_OnOffBTN_GestureRecognizer recognizer(gestures, 200);
+        CHECK(recognizer.feed(status(true, true), 1000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(1000 + ONOFFBTN_GESTURE_CLICK_TIMEOUT) == ONOFFBTN_NO_GESTURE);
+
+        gestures[126].Presses = 1;
+        CHECK(recognizer.feed(status(true, true), 5000) == ONOFFBTN_NO_GESTURE);
+        CHECK(recognizer.update(5000 + ONOFFBTN_GESTURE_CLICK_TIMEOUT) == 126);
+    }
+
+    return TEST_RESULT();
+}
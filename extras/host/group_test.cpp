@@ -0,0 +1,50 @@
+/**
+    @file     group_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Group commits: changed spans only, failed transfers are counted and
+    resent.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_group.h"
+#include "host_test.h"
+
+#define FRAMEBUFFER (fakeDevice.Registers + 0xd0)
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+    HHTronik_OnOffBTN_Group group;
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+    const uint8_t *frames[1] = { frame };
+
+    fakeDevice_reset();
+    btn.begin();
+    CHECK(group.add(btn));
+
+    memset(frame, 0, sizeof(frame));
+    frame[4] = 9;
+    CHECK(group.commit(frames) == 1);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    // unchanged: nothing sent
+    uint32_t writes = fakeDevice.Writes;
+    CHECK(group.commit(frames) == 0);
+    CHECK(fakeDevice.Writes == writes);
+
+    // the transfer is NACKed: counted as bus error, not as changed
+    frame[10] = 3;
+    fakeDevice.FailOperations = 1;
+    CHECK(group.commit(frames) == 0);
+    CHECK(btn.getBusErrorCount() == 1);
+    CHECK(FRAMEBUFFER[10] == 0);
+
+    // the next commit reads back and sends what's missing
+    CHECK(group.commit(frames) == 1);
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+    CHECK(btn.getBusErrorCount() == 1);
+
+    return TEST_RESULT();
+}
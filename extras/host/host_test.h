@@ -0,0 +1,30 @@
+/**
+    @file     host_test.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Checks for the host programs of extras/host.sh: a failed CHECK() prints
+    where and makes main() return 1 through TEST_RESULT().
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_HOST_TEST_H_
+#define _HHTRONIK_ONOFFBTN_HOST_TEST_H_
+
+#include <stdio.h>
+#include "fake_device.h"
+
+static int test_failures = 0;
+
+#define CHECK(condition) \
+  do { \
+    if(!(condition)) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      test_failures++; \
+    } \
+  } while(0)
+
+#define TEST_RESULT()   (printf("%s: %s\n", __FILE__, test_failures ? "FAILED" : "ok"), test_failures ? 1 : 0)
+
+#endif
@@ -0,0 +1,112 @@
+/**
+    @file     profile_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Configuration profiles: only differing registers are written, 16 bit
+    registers always as a whole, the save waits for the RTC commit.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+#include "host_test.h"
+
+static const OnOffBTN_ConfigurationProfile profile = {
+    1000, { false, 5, true, delay1000ms }, { true, false, true, false }, 200, 500,
+    Animation_Flash, 100, 0, Animation_Breath, 3, 0, true, false,
+    { false, RTCAlarm_Toggle, true, false, delay1000ms }, { 30, 0, 0, false, true, true }, { 0, false, true }
+};
+
+/**
+ * true when the logged writes cover both bytes of the 16 bit register reg
+ * in the same transfer, or neither byte
+ */
+static bool
+writtenAsUnit(uint8_t reg)
+{
+    for(uint8_t i = 0; i < fakeDevice.LogLength; i++)
+    {
+        uint8_t first = fakeDevice.Log[i].Register;
+        uint8_t last = first + fakeDevice.Log[i].Length - 1;
+
+        bool high = first <= reg && reg <= last;
+        bool low = first <= reg + 1 && reg + 1 <= last;
+
+        if(high != low) return false;
+    }
+
+    return true;
+}
+
+static uint32_t
+writtenBytes(uint8_t reg)
+{
+    uint32_t bytes = 0;
+
+    for(uint8_t i = 0; i < fakeDevice.LogLength; i++)
+    {
+        if(fakeDevice.Log[i].Register == reg) bytes += fakeDevice.Log[i].Length;
+    }
+
+    return bytes;
+}
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    CHECK(btn.applyProfile(profile));
+    CHECK(btn.getLongPressThreshold() == 1000);
+    CHECK(btn.getOnDelay() == 200);
+    CHECK(btn.getOffDelay() == 500);
+
+    // applied already: nothing to write
+    fakeDevice.LogLength = 0;
+    CHECK(!btn.applyProfile(profile));
+    CHECK(fakeDevice.LogLength == 0);
+
+    // one byte of each 16 bit register differs
+    OnOffBTN_ConfigurationProfile changed = profile;
+    changed.LongPressThreshold = 1001;      // low byte
+    changed.OnDelay = 200 + 0x100;          // high byte
+    changed.OffDelay = 500 + 0x101;         // both
+
+    fakeDevice.LogLength = 0;
+    CHECK(btn.applyProfile(changed));
+    CHECK(writtenAsUnit(0x02));
+    CHECK(writtenAsUnit(0x06));
+    CHECK(writtenAsUnit(0x08));
+    CHECK(writtenBytes(0x04) == 0);         // 8 bit registers are still diffed
+    CHECK(btn.getLongPressThreshold() == 1001);
+    CHECK(btn.getOnDelay() == 200 + 0x100);
+    CHECK(btn.getOffDelay() == 500 + 0x101);
+
+    // the device only got the register bytes that changed
+    fakeDevice.LogLength = 0;
+    changed.OnAnimationSpeed = 50;
+    CHECK(btn.applyProfile(changed));
+    CHECK(writtenBytes(0x0b) == 1);
+
+    // configuration and RTC control change: nothing may follow the RTC
+    // commit for ONOFFBTN_RTC_COMMIT_TIME, the save neither
+    fakeDevice.LogLength = 0;
+    changed.OnAnimationSpeed = 60;
+    changed.RTCConfiguration.AlarmEnabled = !changed.RTCConfiguration.AlarmEnabled;
+    CHECK(btn.applyProfile(changed));
+
+    int8_t commit = -1;
+    int8_t save = -1;
+    for(uint8_t i = 0; i < fakeDevice.LogLength; i++)
+    {
+        if(fakeDevice.Log[i].Register == 0xb0) commit = i;
+        if(fakeDevice.Log[i].Register == 0x01) save = i;
+    }
+
+    CHECK(commit >= 0 && save > commit);
+    CHECK(save > commit && fakeDevice.Log[save].Time - fakeDevice.Log[commit].Time >= ONOFFBTN_RTC_COMMIT_TIME * 1000UL);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,97 @@
+/**
+    @file     records_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Record store: blank EEPROM, rotation, versions and interrupted writes.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_records.h"
+#include "host_test.h"
+
+#define EEPROM (fakeDevice.Registers + 0x30)
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+    uint32_t value;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    // zeroed and erased cells hold no record, whatever the version
+    for(uint16_t version = 0; version < 255; version++)
+    {
+        HHTronik_OnOffBTN_RecordStore store(btn, 4, version);
+
+        memset(EEPROM, 0x00, ONOFFBTN_USER_EEPROM_SIZE);
+        CHECK(!store.read((uint8_t *)&value));
+
+        memset(EEPROM, 0xff, ONOFFBTN_USER_EEPROM_SIZE);
+        CHECK(!store.read((uint8_t *)&value));
+    }
+
+    // rotation: the newest record wins, across sequence wrap-arounds
+    {
+        HHTronik_OnOffBTN_RecordStore store(btn, 4, 1);
+        CHECK(store.getSlotCount() == 2);
+
+        for(uint32_t i = 0; i < 300; i++)
+            CHECK(store.write((uint8_t *)&i));
+
+        CHECK(store.read((uint8_t *)&value) && value == 299);
+
+        // an all-zero record is a record
+        value = 0;
+        CHECK(store.write((uint8_t *)&value));
+        value = 1;
+        CHECK(store.read((uint8_t *)&value) && value == 0);
+
+        // unchanged records aren't written
+        uint32_t writes = fakeDevice.Writes;
+        CHECK(store.write((uint8_t *)&value));
+        CHECK(fakeDevice.Writes == writes);
+
+        // other layout version
+        HHTronik_OnOffBTN_RecordStore other(btn, 4, 2);
+        CHECK(!other.read((uint8_t *)&value));
+    }
+
+    // an interrupted write leaves the previous record
+    {
+        HHTronik_OnOffBTN_RecordStore store(btn, 4, 1);
+        memset(EEPROM, 0xff, ONOFFBTN_USER_EEPROM_SIZE);
+
+        value = 1234;
+        CHECK(store.write((uint8_t *)&value));
+
+        uint8_t written[ONOFFBTN_USER_EEPROM_SIZE];
+        memcpy(written, EEPROM, ONOFFBTN_USER_EEPROM_SIZE);
+
+        // the next slot is erased: every byte of the new one changes
+        for(uint8_t limit = 0; limit < 6; limit++)
+        {
+            uint32_t next = 5678 + limit;
+            memcpy(EEPROM, written, ONOFFBTN_USER_EEPROM_SIZE);
+            fakeDevice.WriteLimit = limit;
+            CHECK(!store.write((uint8_t *)&next));
+            CHECK(store.read((uint8_t *)&value) && value == 1234);
+        }
+    }
+
+    // ... unless there's a single slot (documented)
+    {
+        uint8_t record[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        HHTronik_OnOffBTN_RecordStore store(btn, sizeof(record), 1);
+        CHECK(store.getSlotCount() == 1);
+
+        CHECK(store.write(record));
+        record[7] = 9;
+        fakeDevice.WriteLimit = 0;          // the new sequence number is lost
+        CHECK(!store.write(record));
+        CHECK(!store.read(record));
+    }
+
+    return TEST_RESULT();
+}
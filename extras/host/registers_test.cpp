@@ -0,0 +1,241 @@
+/**
+    @file     registers_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Randomized round trips of the driver's setter/getter pairs against the
+    simulated register file: register contents, transfer framing (start
+    register and length of every burst) and the multi-byte paths.
+    hhtronik_onoffbtn_codec_check.cpp covers the pure codecs at compile
+    time, this covers what goes over the bus.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+#include "host_test.h"
+
+#define ROUNDS  (2000)
+
+static uint32_t random_state = 1;
+
+static uint8_t
+nextRandom( void )
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return (uint8_t)random_state;
+}
+
+static uint8_t
+randomBcd(uint8_t max)
+{
+    uint8_t value = nextRandom() % (max + 1);
+    return OnOffBTN_decToBcd(value);
+}
+
+/**
+ * true when the last transfers were exactly one write of length bytes at reg
+ */
+static bool
+wroteOnce(uint8_t reg, uint8_t length)
+{
+    return fakeDevice.LogLength == 1 && fakeDevice.Log[0].Register == reg && fakeDevice.Log[0].Length == length;
+}
+
+static void
+checkShort(HHTronik_OnOffBTN &btn, uint8_t reg, uint16_t (HHTronik_OnOffBTN::*get)(void), void (HHTronik_OnOffBTN::*set)(uint16_t))
+{
+    uint16_t raw = (fakeDevice.Registers[reg] << 8) | fakeDevice.Registers[reg + 1];
+    CHECK((btn.*get)() == raw);
+
+    uint16_t value = (nextRandom() << 8) | nextRandom();
+    fakeDevice.LogLength = 0;
+    (btn.*set)(value);
+    CHECK(wroteOnce(reg, 2));
+    CHECK((btn.*get)() == value);
+}
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    for(uint16_t round = 0; round < ROUNDS; round++)
+    {
+        uint8_t before[256];
+
+        for(uint16_t i = 0; i < 256; i++)
+            fakeDevice.Registers[i] = nextRandom();
+
+        // 16 bit registers, MSB first
+        checkShort(btn, 0x02, &HHTronik_OnOffBTN::getLongPressThreshold, &HHTronik_OnOffBTN::setLongPressThreshold);
+        checkShort(btn, 0x06, &HHTronik_OnOffBTN::getOnDelay, &HHTronik_OnOffBTN::setOnDelay);
+        checkShort(btn, 0x08, &HHTronik_OnOffBTN::getOffDelay, &HHTronik_OnOffBTN::setOffDelay);
+
+        // configuration registers: writing back what was read keeps the register
+        uint8_t raw = fakeDevice.Registers[0x04];
+        btn.setHardResetBehaviorConfiguration(btn.getHardResetBehaviorConfiguration());
+        CHECK(fakeDevice.Registers[0x04] == raw);
+
+        raw = fakeDevice.Registers[0x05];
+        btn.setPowerBehaviorConfiguration(btn.getPowerOnResetConfiguration());
+        CHECK(fakeDevice.Registers[0x05] == (raw & 15));
+
+        bool restoreOn = nextRandom() & 1;
+        bool restoreOff = nextRandom() & 1;
+        btn.setFramebufferRestoreBehavior(restoreOn, restoreOff);
+        CHECK(fakeDevice.Registers[0x10] == (restoreOn | (restoreOff << 1)));
+
+        // animations
+        OnOffBTN_PowerState state = (nextRandom() & 1) ? PowerOn : PowerOff;
+        uint8_t value = nextRandom();
+        btn.setAnimationSpeed(state, value);
+        CHECK(btn.getAnimationSpeed(state) == value);
+        CHECK(fakeDevice.Registers[state == PowerOn ? 0x0b : 0x0e] == value);
+
+        value = nextRandom();
+        btn.setAnimationConfiguration(state, value);
+        CHECK(btn.getAnimationConfiguration(state) == value);
+
+        OnOffBTN_Animation animation = (OnOffBTN_Animation)(nextRandom() % 8);
+        btn.selectAnimation(state, animation);
+        CHECK(btn.getSelectedAnimation(state) == animation);
+
+        // RTC control
+        raw = fakeDevice.Registers[0xb0];
+        btn.setRTCConfiguration(btn.getRTCConfiguration());
+        CHECK(fakeDevice.Registers[0xb0] == (raw & 127));
+
+        // date/time: valid contents survive a get/set, in one 7 byte burst
+        fakeDevice.Registers[0xb1] = randomBcd(59);
+        fakeDevice.Registers[0xb2] = randomBcd(59);
+        fakeDevice.Registers[0xb3] = randomBcd(23);
+        fakeDevice.Registers[0xb4] = randomBcd(31);
+        fakeDevice.Registers[0xb5] = randomBcd(12);
+        fakeDevice.Registers[0xb6] = randomBcd(99);
+        fakeDevice.Registers[0xb7] = nextRandom() & 7;
+        memcpy(before, fakeDevice.Registers, sizeof(before));
+
+        fakeDevice.LogLength = 0;
+        btn.setDateTime(btn.getDateTime());
+        CHECK(wroteOnce(0xb1, 7));
+        CHECK(memcmp(before, fakeDevice.Registers, sizeof(before)) == 0);
+
+        // any date/time: written as valid, clamped BCD
+        OnOffBTN_DateTime dateTime = { nextRandom(), nextRandom(), nextRandom(), nextRandom(), nextRandom(), nextRandom(), nextRandom() };
+        btn.setDateTime(dateTime);
+        OnOffBTN_DateTime read = btn.getDateTime();
+        CHECK(read.Seconds == (dateTime.Seconds > 59 ? 59 : dateTime.Seconds));
+        CHECK(read.Minutes == (dateTime.Minutes > 59 ? 59 : dateTime.Minutes));
+        CHECK(read.Hours == (dateTime.Hours > 23 ? 23 : dateTime.Hours));
+        CHECK(read.DayOfMonth == (dateTime.DayOfMonth > 31 ? 31 : dateTime.DayOfMonth));
+        CHECK(read.Month == (dateTime.Month > 12 ? 12 : dateTime.Month));
+        CHECK(read.Year == (dateTime.Year > 99 ? 99 : dateTime.Year));
+        CHECK(read.DayOfWeek == (dateTime.DayOfWeek & 7));
+        CHECK(memcmp(before, fakeDevice.Registers, 0xb1) == 0);
+        CHECK(memcmp(before + 0xb8, fakeDevice.Registers + 0xb8, 256 - 0xb8) == 0);
+
+        // alarm time: one 3 byte burst, clamped, masks kept
+        OnOffBTN_AlarmTime alarm = OnOffBTN_AlarmTime();
+        alarm.Seconds = nextRandom();
+        alarm.Minutes = nextRandom();
+        alarm.Hours = nextRandom();
+        alarm.MaskSeconds = nextRandom() & 1;
+        alarm.MaskMinutes = nextRandom() & 1;
+        alarm.MaskHours = nextRandom() & 1;
+
+        fakeDevice.LogLength = 0;
+        btn.setAlarmTime(alarm);
+        CHECK(wroteOnce(0xb8, 3));
+
+        OnOffBTN_AlarmTime alarmRead = btn.getAlarmTime();
+        CHECK(alarmRead.Seconds == (alarm.Seconds > 59 ? 59 : alarm.Seconds));
+        CHECK(alarmRead.Minutes == (alarm.Minutes > 59 ? 59 : alarm.Minutes));
+        CHECK(alarmRead.Hours == (alarm.Hours > 23 ? 23 : alarm.Hours));
+        CHECK(alarmRead.MaskSeconds == alarm.MaskSeconds);
+        CHECK(alarmRead.MaskMinutes == alarm.MaskMinutes);
+        CHECK(alarmRead.MaskHours == alarm.MaskHours);
+
+        // alarm day/date
+        OnOffBTN_AlarmDayDate dayDate = OnOffBTN_AlarmDayDate();
+        dayDate.Value = nextRandom() & 63;
+        dayDate.IsWeekDayAlarm = nextRandom() & 1;
+        dayDate.DayDateMasked = nextRandom() & 1;
+        btn.setAlarmDayDate(dayDate);
+
+        OnOffBTN_AlarmDayDate dayDateRead = btn.getAlarmDayDate();
+        CHECK(dayDateRead.IsWeekDayAlarm == dayDate.IsWeekDayAlarm);
+        CHECK(dayDateRead.DayDateMasked == dayDate.DayDateMasked);
+        CHECK(dayDateRead.Value == (dayDate.IsWeekDayAlarm ? (dayDate.Value & 7) : (dayDate.Value > 31 ? 31 : dayDate.Value)));
+
+        // User-EEPROM: any offset/length, nothing outside the range changes
+        uint8_t eeprom[ONOFFBTN_USER_EEPROM_SIZE + 4];
+        uint8_t offset = nextRandom() % (ONOFFBTN_USER_EEPROM_SIZE + 2);
+        uint8_t length = nextRandom() % (ONOFFBTN_USER_EEPROM_SIZE + 4);
+        uint8_t expected = offset >= ONOFFBTN_USER_EEPROM_SIZE || length == 0 ? 0
+            : (length > ONOFFBTN_USER_EEPROM_SIZE - offset ? ONOFFBTN_USER_EEPROM_SIZE - offset : length);
+
+        for(uint8_t i = 0; i < sizeof(eeprom); i++)
+            eeprom[i] = nextRandom();
+
+        memcpy(before, fakeDevice.Registers, sizeof(before));
+        CHECK(btn.writeUserEEPROM(offset, eeprom, length) <= expected);
+        memcpy(before + 0x30 + offset, eeprom, expected);
+        CHECK(memcmp(before, fakeDevice.Registers, sizeof(before)) == 0);
+
+        uint8_t eepromRead[ONOFFBTN_USER_EEPROM_SIZE + 4];
+        memset(eepromRead, 0xa5, sizeof(eepromRead));
+        CHECK(btn.readUserEEPROM(offset, eepromRead, length) == expected);
+        CHECK(memcmp(eepromRead, eeprom, expected) == 0);
+        CHECK(expected == sizeof(eepromRead) || eepromRead[expected] == 0xa5);
+
+        // framebuffer: partial frames and the readback
+        uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+        uint8_t frameRead[ONOFFBTN_FRAMEBUFFER_SIZE];
+        offset = nextRandom() % ONOFFBTN_FRAMEBUFFER_SIZE;
+        length = 1 + nextRandom() % (ONOFFBTN_FRAMEBUFFER_SIZE - offset);
+
+        for(uint8_t i = 0; i < sizeof(frame); i++)
+            frame[i] = nextRandom();
+
+        memcpy(before, fakeDevice.Registers, sizeof(before));
+        fakeDevice.LogLength = 0;
+        btn.setPixels(frame, length, offset);
+        CHECK(wroteOnce(0xd0 + offset, length));
+        memcpy(before + 0xd0 + offset, frame, length);
+        CHECK(memcmp(before, fakeDevice.Registers, sizeof(before)) == 0);
+
+        CHECK(btn.readFramebuffer(frameRead));
+        CHECK(memcmp(frameRead, fakeDevice.Registers + 0xd0, ONOFFBTN_FRAMEBUFFER_SIZE) == 0);
+        CHECK(memcmp(btn.getFramebuffer(), frameRead, ONOFFBTN_FRAMEBUFFER_SIZE) == 0);
+
+        // only the changed subpixels go out afterwards
+        for(uint8_t i = 0; i < sizeof(frame); i++)
+            frame[i] = (nextRandom() & 3) ? frameRead[i] : nextRandom();
+
+        btn.updateFramebuffer(frame);
+        CHECK(memcmp(frame, fakeDevice.Registers + 0xd0, ONOFFBTN_FRAMEBUFFER_SIZE) == 0);
+    }
+
+    // failed reads are reported and don't run past the buffers
+    for(uint16_t round = 0; round < ROUNDS; round++)
+    {
+        uint8_t buffer[ONOFFBTN_USER_EEPROM_SIZE + 1];
+        uint16_t errors = btn.getBusErrorCount();
+
+        buffer[ONOFFBTN_USER_EEPROM_SIZE] = 0x5a;
+        fakeDevice.FailOperations = 1 + nextRandom() % 2;
+
+        CHECK(btn.readUserEEPROM(0, buffer, ONOFFBTN_USER_EEPROM_SIZE) <= ONOFFBTN_USER_EEPROM_SIZE);
+        CHECK(buffer[ONOFFBTN_USER_EEPROM_SIZE] == 0x5a);
+        CHECK(btn.getBusErrorCount() == errors + 1);
+
+        fakeDevice.FailOperations = 0;
+        btn.setBusClock(100000);
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,134 @@
+/**
+    @file     scheduler_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Bus scheduler: status reads preempt frames at the next chunk boundary,
+    no chunk starves when frames come faster than they're sent, failed
+    chunks don't leave a wrong framebuffer copy.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_scheduler.h"
+#include "host_test.h"
+
+#define FRAMEBUFFER (fakeDevice.Registers + 0xd0)
+#define CHUNK       (ONOFFBTN_SCHEDULER_CHUNK_PIXELS * 3)
+
+static HHTronik_OnOffBTN btn;
+static HHTronik_OnOffBTN_Scheduler scheduler(btn);
+
+static uint32_t interruptAt;
+static uint32_t transfers;
+
+// the INT pin rises once a given bus operation is over
+static void
+interrupt( void )
+{
+    if(++transfers == interruptAt) scheduler.notifyInterrupt();
+}
+
+// same formula as the fake device: START, address, bytes, STOP
+static uint32_t
+transferTime(uint8_t bytes)
+{
+    return ((bytes + 1) * 9 + 2) * 1000000UL / 400000;
+}
+
+int main()
+{
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    fakeDevice_reset();
+    btn.begin();
+    btn.setBusClock(400000);
+
+    memset(frame, 0, sizeof(frame));
+    CHECK(btn.readFramebuffer());
+
+    // a frame every loop, one chunk per loop: every chunk still gets its turn
+    for(uint8_t loop = 1; loop <= 20; loop++)
+    {
+        memset(frame, loop, sizeof(frame));
+        scheduler.queueFrame(frame);
+        scheduler.poll(1);
+    }
+
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i += CHUNK)
+        CHECK(FRAMEBUFFER[i] >= 20 - ONOFFBTN_FRAMEBUFFER_SIZE / CHUNK);
+
+    while(scheduler.poll()) ;
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    // unchanged chunks are skipped without counting
+    frame[ONOFFBTN_FRAMEBUFFER_SIZE - 1] = 0x80;
+    uint32_t writes = fakeDevice.Writes;
+    scheduler.queueFrame(frame);
+    while(scheduler.poll(1)) ;
+    CHECK(fakeDevice.Writes == writes + 1);
+    CHECK(FRAMEBUFFER[ONOFFBTN_FRAMEBUFFER_SIZE - 1] == 0x80);
+
+    // the status read preempts the frame: interrupt after every single bus
+    // operation of a full frame in turn, the read never waits for more than
+    // the chunk on the bus when the INT pin rose
+    fakeDevice.OnTransfer = interrupt;
+    scheduler.resetStatusLatency();
+
+    for(interruptAt = 1; interruptAt <= ONOFFBTN_FRAMEBUFFER_SIZE / CHUNK; interruptAt++)
+    {
+        for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++) frame[i] ^= 0xff;
+
+        transfers = 0;
+        scheduler.queueFrame(frame);
+        while(scheduler.poll()) ;
+
+        CHECK(scheduler.hasStatus());
+        scheduler.takeStatus();
+    }
+
+    fakeDevice.OnTransfer = NULL;
+
+    // one chunk (register + subpixels) and a status read (register, then
+    // one byte) at most
+    uint32_t worst = transferTime(1 + CHUNK) + transferTime(1) * 2;
+    CHECK(scheduler.getWorstStatusLatency() > 0);
+    CHECK(scheduler.getWorstStatusLatency() <= worst);
+
+    // far below a whole frame in one transfer
+    CHECK(worst < transferTime(1 + ONOFFBTN_FRAMEBUFFER_SIZE));
+
+    // a chunk NACKs: the frame is resent and the copy only trusted once it
+    // arrived
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++) frame[i] = i;
+    scheduler.queueFrame(frame);
+    fakeDevice.FailOperations = 1;
+    scheduler.poll(1);
+    scheduler.poll(1);
+
+    uint32_t operations = fakeDevice.Operations;
+    btn.getFramebuffer();
+    CHECK(fakeDevice.Operations > operations);      // read back, not trusted
+
+    while(scheduler.poll()) ;
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    // power state change (the device restores a stored framebuffer) in the
+    // middle of a resend: it starts over
+    memset(FRAMEBUFFER, 0x33, ONOFFBTN_FRAMEBUFFER_SIZE);
+    fakeDevice.Registers[0x00] = ONOFFBTN_STATUS_POWERON;
+    scheduler.requestStatus();
+    scheduler.queueFrame(frame);
+    scheduler.poll(1);
+
+    memset(FRAMEBUFFER, 0x44, ONOFFBTN_FRAMEBUFFER_SIZE);
+    fakeDevice.Registers[0x00] = 0;
+    scheduler.requestStatus();
+    while(scheduler.poll()) ;
+    CHECK(memcmp(FRAMEBUFFER, frame, sizeof(frame)) == 0);
+
+    operations = fakeDevice.Operations;
+    btn.getFramebuffer();
+    CHECK(fakeDevice.Operations == operations);     // trusted again
+
+    return TEST_RESULT();
+}
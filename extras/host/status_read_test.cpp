@@ -0,0 +1,49 @@
+/**
+    @file     status_read_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Status read cost, the figure the latency example builds on: one
+    register select and a one byte read, ~39 bit times on the wire.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+#include "host_test.h"
+
+#define READS       (100)
+
+int main()
+{
+    static const uint32_t clocks[] = { 100000, 400000, 1000000 };
+
+    HHTronik_OnOffBTN btn;
+
+    fakeDevice_reset();
+    btn.begin();
+
+    for(uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        btn.setBusClock(clocks[c]);
+
+        uint32_t operations = fakeDevice.Operations;
+        uint32_t start = micros();
+        for(uint8_t i = 0; i < READS; i++) btn.getRawButtonStatus();
+        uint32_t perRead = (micros() - start) / READS;
+
+        // two bus operations, nothing written
+        CHECK(fakeDevice.Operations - operations == READS * 2);
+        CHECK(fakeDevice.Writes == 0);
+
+        // the latency example's model: 39 bit times (us), the fake device
+        // counts a STOP and START instead of the repeated START
+        uint32_t model = 39000000UL / clocks[c];
+        CHECK(perRead >= model && perRead <= model + 2000000UL / clocks[c]);
+    }
+
+    // the status bits come through unchanged
+    fakeDevice.Registers[0x00] = ONOFFBTN_STATUS_SHORTPRESS | ONOFFBTN_STATUS_POWERON;
+    CHECK(btn.getRawButtonStatus() == (ONOFFBTN_STATUS_SHORTPRESS | ONOFFBTN_STATUS_POWERON));
+
+    return TEST_RESULT();
+}
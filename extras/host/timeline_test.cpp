@@ -0,0 +1,41 @@
+/**
+    @file     timeline_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Keyframe timelines: the shortest and longest keyframes play in full.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_timeline.h"
+#include "host_test.h"
+
+const uint8_t timeline[] PROGMEM = {
+    ONOFFBTN_KEYFRAME(10, Easing_Step),       ONOFFBTN_COLOR(9, 255, 0, 0),
+    ONOFFBTN_KEYFRAME(2550, Easing_Linear),   ONOFFBTN_COLOR(3, 0, 0, 255), ONOFFBTN_KEEP(6),
+    ONOFFBTN_KEYFRAME(1999, Easing_Linear),   ONOFFBTN_COLOR(9, 0, 0, 0),   // 1990ms
+    ONOFFBTN_TIMELINE_END
+};
+
+int main()
+{
+    HHTronik_OnOffBTN_Sequencer sequencer;
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    CHECK(HHTronik_OnOffBTN_Sequencer::getTimelineDuration(timeline) == 10 + 2550 + 1990);
+    CHECK(HHTronik_OnOffBTN_Sequencer::getTimelineSize(timeline) == sizeof(timeline));
+
+    sequencer.play(timeline, 1000);
+
+    CHECK(sequencer.render(1005, frame));
+    CHECK(sequencer.render(1010, frame) && frame[0] == 255 && frame[2] == 0);
+
+    // halfway through the long keyframe
+    CHECK(sequencer.render(1010 + 1275, frame) && frame[0] == 128 && frame[2] == 127);
+    CHECK(sequencer.render(1010 + 2549, frame) && frame[2] == 254 && frame[26] == 0);
+
+    CHECK(sequencer.render(1010 + 2550 + 1989, frame));
+    CHECK(!sequencer.render(1010 + 2550 + 1990, frame) && frame[0] == 0 && frame[26] == 0);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,58 @@
+/**
+    @file     watchdog_test.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    RTC watchdog: arm() waits for the RTC commit, kick() moves the alarm
+    once per second.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_watchdog.h"
+#include "host_test.h"
+
+int main()
+{
+    HHTronik_OnOffBTN btn;
+    HHTronik_OnOffBTN_Watchdog watchdog(btn);
+
+    fakeDevice_reset();
+    btn.begin();
+
+    // RTC at 10:20:30
+    fakeDevice.Registers[0xb1] = 0x30;
+    fakeDevice.Registers[0xb2] = 0x20;
+    fakeDevice.Registers[0xb3] = 0x10;
+
+    // the RTC configuration changes: nothing may follow the commit for 500ms
+    unsigned long start = millis();
+    CHECK(watchdog.arm(10));
+    CHECK(millis() - start >= ONOFFBTN_RTC_COMMIT_TIME);
+    CHECK(fakeDevice.LogLength >= 1 && fakeDevice.Log[fakeDevice.LogLength - 1].Register == 0xb0);
+    CHECK(fakeDevice.Registers[0xb8] == 0x40);      // 10:20:40
+
+    // armed already: no commit to wait for
+    start = millis();
+    CHECK(watchdog.arm(10));
+    CHECK(millis() - start < ONOFFBTN_RTC_COMMIT_TIME);
+
+    // kicks within the same second don't use the bus
+    uint32_t operations = fakeDevice.Operations;
+    watchdog.kick();
+    watchdog.kick();
+    CHECK(fakeDevice.Operations == operations);
+
+    // a second later: a single byte burst to ALMAR1
+    delay(1000);
+    fakeDevice.LogLength = 0;
+    watchdog.kick();
+    CHECK(fakeDevice.LogLength == 1 && fakeDevice.Log[0].Register == 0xb8 && fakeDevice.Log[0].Length == 1);
+    CHECK(fakeDevice.Registers[0xb8] == 0x41);
+
+    start = millis();
+    watchdog.disarm();
+    CHECK(millis() - start >= ONOFFBTN_RTC_COMMIT_TIME);
+    CHECK(!watchdog.isArmed());
+
+    return TEST_RESULT();
+}
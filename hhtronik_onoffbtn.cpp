@@ -10,11 +10,20 @@
 #include <Wire.h>
 #include "hhtronik_onoffbtn.h"
 
+uint32_t HHTronik_OnOffBTN::_busClock = ONOFFBTN_BUS_CLOCK_DEFAULT;
+uint32_t HHTronik_OnOffBTN::_busClockTarget = ONOFFBTN_BUS_CLOCK_DEFAULT;
+uint8_t HHTronik_OnOffBTN::_busErrorStreak = 0;
+uint16_t HHTronik_OnOffBTN::_busGoodStreak = 0;
+
 /////////////////////////////////////////////////////////
 // Constructors:
 
 HHTronik_OnOffBTN::HHTronik_OnOffBTN()
 {
+    _lastStatus = 0;
+    _framebufferValid = false;
+    _busErrors = 0;
+    _lastTransferOk = true;
 }
 
 /////////////////////////////////////////////////////////
@@ -25,8 +34,9 @@ HHTronik_OnOffBTN::_i2c_readByte(uint8_t reg)
 {
     Wire.beginTransmission(i2c_addr);       // send address
     Wire.write(reg);                        // select register
-    Wire.endTransmission(false);            // end write, but don't send STOP condition
-    Wire.requestFrom(i2c_addr, (uint8_t)1); // now start read of 1 byte
+    bool ok = !Wire.endTransmission(false); // end write, but don't send STOP condition
+    ok &= Wire.requestFrom(i2c_addr, (uint8_t)1) == 1; // now start read of 1 byte
+    _i2c_result(ok);
     return (uint8_t)Wire.read();            // read 1 byte
 }
 
@@ -36,7 +46,7 @@ HHTronik_OnOffBTN::_i2c_writeByte(uint8_t reg, uint8_t value)
     Wire.beginTransmission(i2c_addr);       // send address
     Wire.write(reg);                        // select register
     Wire.write(value);                      // write value
-    Wire.endTransmission();                 // done.
+    _i2c_result(!Wire.endTransmission());   // done.
 }
 
 uint16_t 
@@ -44,8 +54,9 @@ HHTronik_OnOffBTN::_i2c_readShort(uint8_t reg)
 {
     Wire.beginTransmission(i2c_addr);       // send address
     Wire.write(reg);                        // select register
-    Wire.endTransmission(false);            // end write, but don't send STOP condition
-    Wire.requestFrom(i2c_addr, (uint8_t)2); // now start read of 1 byte
+    bool ok = !Wire.endTransmission(false); // end write, but don't send STOP condition
+    ok &= Wire.requestFrom(i2c_addr, (uint8_t)2) == 2; // now start read of 2 bytes
+    _i2c_result(ok);
     
     uint16_t result = 0;
     result = ((uint16_t)Wire.read()) << 8;  // read 1 byte
@@ -61,10 +72,154 @@ HHTronik_OnOffBTN::_i2c_writeShort(uint8_t reg, uint16_t value)
     Wire.write(reg);                        // select register
     Wire.write(value >> 8);                 // write MSB value
     Wire.write(value & 0xff);               // write LSB value
-    Wire.endTransmission();                 // done.
+    _i2c_result(!Wire.endTransmission());   // done.
     Wire.flush();
 }
 
+uint8_t 
+HHTronik_OnOffBTN::_i2c_writeChanged(uint8_t reg, const uint8_t *current, const uint8_t *wanted, uint8_t length, uint8_t mergeGap)
+{
+    uint8_t written = 0;
+    uint8_t i = 0;
+    bool ok = true;
+
+    // write every run of changed bytes in a single burst, runs separated by
+    // no more than mergeGap unchanged bytes are sent together
+    while(i < length)
+    {
+        if(current[i] == wanted[i])
+        {
+            i++;
+            continue;
+        }
+
+        uint8_t start = i;
+        uint8_t end = i;
+
+        while(i < length && i - end <= mergeGap + 1)
+        {
+            if(current[i] != wanted[i]) end = i;
+            i++;
+        }
+
+        i = end + 1;
+
+        _i2c_writeBytes(reg + start, wanted + start, i - start);
+        ok &= _lastTransferOk;
+        written += i - start;
+    }
+
+    // callers check the whole diff, not only its last burst
+    _lastTransferOk = ok;
+
+    return written;
+}
+
+uint8_t 
+HHTronik_OnOffBTN::_i2c_readBytes(uint8_t reg, uint8_t *buffer, uint8_t length) 
+{
+    uint8_t i = 0;
+
+    Wire.beginTransmission(i2c_addr);       // send address
+    Wire.write(reg);                        // select first register
+    bool ok = !Wire.endTransmission(false); // end write, but don't send STOP condition
+    ok &= Wire.requestFrom(i2c_addr, length) == length; // now start read of length bytes
+    _i2c_result(ok);
+
+    while(Wire.available() > 0 && i < length)
+        buffer[i++] = Wire.read();
+
+    return i;
+}
+
+void 
+HHTronik_OnOffBTN::_i2c_writeBytes(uint8_t reg, const uint8_t *buffer, uint8_t length)
+{
+    Wire.beginTransmission(i2c_addr);       // send address
+    Wire.write(reg);                        // select first register
+    Wire.write(buffer, length);             // the device auto-increments the register address
+    _i2c_result(!Wire.endTransmission());   // done.
+}
+
+void
+HHTronik_OnOffBTN::_i2c_result(bool ok)
+{
+    _lastTransferOk = ok;
+
+    if(ok)
+    {
+        _busErrorStreak = 0;
+
+        // stepped down a while ago and fine since: try the next rate up
+        if(_busClock < _busClockTarget && ++_busGoodStreak >= ONOFFBTN_BUS_RECOVERY_LIMIT)
+        {
+            uint32_t clock = _busClock < 400000 ? 400000 : 1000000;
+            _applyBusClock(clock < _busClockTarget ? clock : _busClockTarget);
+        }
+
+        return;
+    }
+
+    if(_busErrors < 0xffff) _busErrors++;
+    _busGoodStreak = 0;
+
+    // the bus doesn't cope with the clock, step down
+    if(++_busErrorStreak >= ONOFFBTN_BUS_ERROR_LIMIT && _busClock > 100000)
+        _applyBusClock(_busClock > 400000 ? 400000 : 100000);
+}
+
+void
+HHTronik_OnOffBTN::_applyBusClock(uint32_t clock)
+{
+    _busClock = clock;
+    _busErrorStreak = 0;
+    _busGoodStreak = 0;
+    Wire.setClock(clock);
+}
+
+uint8_t
+HHTronik_OnOffBTN::_readBusProbe(uint8_t *buffer)
+{
+    uint8_t length = ONOFFBTN_CONFIG_LENGTH;
+
+    // configuration registers (and User-EEPROM), they only change when written
+    if(_i2c_readBytes(ONOFFBTN_CONFIG_FIRST_REGISTER, buffer, ONOFFBTN_CONFIG_LENGTH) != ONOFFBTN_CONFIG_LENGTH)
+        return 0;
+
+    buffer[14] &= 3;                        // 0x10 bits 2-7 are commands
+
+#if ONOFFBTN_ENABLE_USER_EEPROM
+    if(_i2c_readBytes(0x30, buffer + length, ONOFFBTN_USER_EEPROM_SIZE) != ONOFFBTN_USER_EEPROM_SIZE)
+        return 0;
+
+    length += ONOFFBTN_USER_EEPROM_SIZE;
+#endif
+
+    return length;
+}
+
+bool
+HHTronik_OnOffBTN::_busRoundTrip(uint8_t round)
+{
+    // all ones and zeros, alternating, walking one and walking zero
+    static const uint8_t patterns[] = {
+        0x00, 0xff, 0x55, 0xaa, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+        0xfe, 0xfd, 0xfb, 0xf7, 0xef, 0xdf, 0xbf, 0x7f
+    };
+
+    uint8_t pattern[ONOFFBTN_FRAMEBUFFER_SIZE];
+    uint8_t readBack[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    // shifted every round, so each subpixel sees every pattern
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+        pattern[i] = patterns[(i + round * 7) % sizeof(patterns)];
+
+    _i2c_writeBytes(0xd0, pattern, ONOFFBTN_FRAMEBUFFER_SIZE);
+    if(!_lastTransferOk) return false;
+
+    return _i2c_readBytes(0xd0, readBack, ONOFFBTN_FRAMEBUFFER_SIZE) == ONOFFBTN_FRAMEBUFFER_SIZE
+        && memcmp(readBack, pattern, ONOFFBTN_FRAMEBUFFER_SIZE) == 0;
+}
 
 /////////////////////////////////////////////////////////
 // Public:
@@ -73,8 +228,9 @@ bool
 HHTronik_OnOffBTN::begin(uint8_t addr)
 {
     this->i2c_addr = addr;
-    Wire.setClock(400000);      // we work in fast mode
     Wire.begin();
+    Wire.setClock(_busClock);   // after Wire.begin(), some cores reset the clock there
+    _framebufferValid = false;
     return true;
 }
 
@@ -82,60 +238,76 @@ bool
 HHTronik_OnOffBTN::begin(uint8_t sdaPin, uint8_t sclPin, uint8_t addr)
 {
     this->i2c_addr = addr;
-    Wire.setClock(400000);      // we work in fast mode
-    Wire.begin();
+#if defined(ESP8266) || defined(ESP32)
+    Wire.begin(sdaPin, sclPin);
+#else
+    Wire.begin();               // fixed I2C pins on this core
+#endif
+    Wire.setClock(_busClock);   // after Wire.begin(), some cores reset the clock there
+    _framebufferValid = false;
     return true;
 }
 
-void 
-HHTronik_OnOffBTN::clearFramebuffer( void )
+void
+HHTronik_OnOffBTN::setBusClock(uint32_t clock)
 {
-    Wire.beginTransmission(i2c_addr);   // send address
-    Wire.write(0xd0);                   // select first byte of framebuffer
+    _busClockTarget = clock;
+    _applyBusClock(clock);
+}
+
+uint32_t
+HHTronik_OnOffBTN::negotiateBusClock(uint32_t maxClock)
+{
+    static const uint32_t clocks[] = { 1000000, 400000 };
+
+    uint8_t reference[ONOFFBTN_BUS_PROBE_SIZE];
+    uint8_t probe[ONOFFBTN_BUS_PROBE_SIZE];
+    uint8_t framebuffer[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    // failed probes are expected, they don't count as bus errors
+    uint16_t errors = _busErrors;
 
-    for(uint8_t i = 0; i < ONOFFBTN_NUM_PIXELS * 3; i++)
+    // the reference (and the framebuffer to restore) is read at the
+    // standard mode rate. Nothing gets written if that fails.
+    setBusClock(100000);
+    uint8_t length = _readBusProbe(reference);
+    bool saved = length > 0 && _i2c_readBytes(0xd0, framebuffer, ONOFFBTN_FRAMEBUFFER_SIZE) == ONOFFBTN_FRAMEBUFFER_SIZE;
+
+    for(uint8_t c = 0; saved && c < sizeof(clocks) / sizeof(clocks[0]); c++)
     {
-        Wire.write(0);
-    }
+        if(clocks[c] > maxClock) continue;
 
-    Wire.endTransmission();
-}
+        setBusClock(clocks[c]);
+        bool ok = true;
 
-void 
-HHTronik_OnOffBTN::setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
-{   
-    // avoid writing over the boundaries 
-    if(pixel > ONOFFBTN_NUM_PIXELS) return;
+        for(uint8_t round = 0; ok && round < ONOFFBTN_BUS_PROBE_ROUNDS; round++)
+        {
+            ok = _readBusProbe(probe) == length && memcmp(probe, reference, length) == 0
+                && _busRoundTrip(round);
+        }
 
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xd0 + pixel * 3);           // select first byte of selected pixel
-    Wire.write(r); 
-    Wire.write(g); 
-    Wire.write(b); 
-    Wire.endTransmission();  
-}
+        // also fails if _i2c_result() stepped the clock down meanwhile
+        if(ok && _busClock == clocks[c]) break;
 
-void 
-HHTronik_OnOffBTN::setPixels(const uint8_t *subpixel, const uint8_t length, const uint8_t offset)
-{
-    if(offset > ONOFFBTN_NUM_PIXELS) return;
-    
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xd0 + offset);              // select first byte of selected subpixel
+        setBusClock(100000);
+    }
 
-    for(uint8_t idx = offset; idx < length + offset; idx++)
+    if(saved)
     {
-        if(idx > ONOFFBTN_NUM_PIXELS * 3) break;
-        Wire.write(*subpixel++);
+        _i2c_writeBytes(0xd0, framebuffer, ONOFFBTN_FRAMEBUFFER_SIZE);
+        _framebufferValid = false;
     }
 
-    Wire.endTransmission();
+    _busErrors = errors;
+    _busErrorStreak = 0;
+
+    return _busClock;
 }
 
 OnOffBTN_StatusRegister 
 HHTronik_OnOffBTN::getButtonStatus()
 {    
-    int rawValue = _i2c_readByte(0x00);     // BUTTON STATUS register at 0x00
+    int rawValue = getRawButtonStatus();
     
     OnOffBTN_StatusRegister result =
     {
@@ -150,6 +322,19 @@ HHTronik_OnOffBTN::getButtonStatus()
     return result;
 }
 
+uint8_t 
+HHTronik_OnOffBTN::getRawButtonStatus( void )
+{
+    uint8_t status = _i2c_readByte(0x00);   // BUTTON STATUS register at 0x00
+
+    // the ÖnÖffBTN may restore a stored framebuffer on power state changes
+    if((status ^ _lastStatus) & ONOFFBTN_STATUS_POWERON)
+        _framebufferValid = false;
+
+    _lastStatus = status;
+    return status;
+}
+
 void
 HHTronik_OnOffBTN::SaveConfiguration( void )
 {
@@ -196,57 +381,28 @@ HHTronik_OnOffBTN::setLongPressThreshold(uint16_t value)
     _i2c_writeShort(0x02, value);
 }
 
-
 OnOffBTN_HardResetBehaviorRegister 
 HHTronik_OnOffBTN::getHardResetBehaviorConfiguration( void )
 {
-    uint8_t regValue = _i2c_readByte(0x04);
-
-    OnOffBTN_HardResetBehaviorRegister result;
-    result.DisableHardReset         = (bool)((regValue & 1)   >> 0); // mask 0b00000001
-    result.HardResetHoldDuration    =       ((regValue & 30)  >> 1); // mask 0b00011110
-    result.AutoRestartAfterReset    = (bool)((regValue & 32)  >> 5); // mask 0b00100000
-    result.AutoRestartDelay         = (OnOffBTN_DelayValue)((regValue & 192) >> 6); // mask 0b11000000
-
-    return result;
+    return OnOffBTN_decodeHardResetBehavior(_i2c_readByte(0x04));
 }
 
 void 
 HHTronik_OnOffBTN::setHardResetBehaviorConfiguration( OnOffBTN_HardResetBehaviorRegister config )
 {
-    uint8_t regValue = 0;
-
-    regValue |= (((uint8_t)config.DisableHardReset)      & 1  ) << 0; // mask 0b00000001
-    regValue |= (((uint8_t)config.HardResetHoldDuration) & 15 ) << 1; // mask 0b00001111
-    regValue |= (((uint8_t)config.AutoRestartAfterReset) & 1  ) << 5; // mask 0b00000001
-    regValue |= (((uint8_t)config.AutoRestartDelay)      & 3  ) << 6; // mask 0b00000011
-    
-    _i2c_writeByte(0x04, regValue);
+    _i2c_writeByte(0x04, OnOffBTN_encodeHardResetBehavior(config));
 }
 
 OnOffBTN_PowerBehaviorRegister 
 HHTronik_OnOffBTN::getPowerOnResetConfiguration( void )
 {
-    uint8_t regValue = _i2c_readByte(0x05);
-
-    OnOffBTN_PowerBehaviorRegister result;
-    result.PoR_DefaultOn            = (bool)((regValue & 1)   >> 0); // mask 0b00000001
-    result.PoR_RestoreFramebuffer   = (bool)((regValue & 2)   >> 1); // mask 0b00000010
-    result.AutoLatchOnOnPress       = (bool)((regValue & 4)   >> 2); // mask 0b00000100
-    result.AutoLatchOnOffPress      = (bool)((regValue & 8)   >> 3); // mask 0b00001000
-
-    return result;
+    return OnOffBTN_decodePowerBehavior(_i2c_readByte(0x05));
 }
 
 void 
 HHTronik_OnOffBTN::setPowerBehaviorConfiguration( OnOffBTN_PowerBehaviorRegister config )
 {
-    uint8_t regValue = 0;
-    regValue |= (((uint8_t)config.PoR_DefaultOn)            & 1 ) << 0; // mask 0b00000001
-    regValue |= (((uint8_t)config.PoR_RestoreFramebuffer)   & 1 ) << 1; // mask 0b00000001    
-    regValue |= (((uint8_t)config.AutoLatchOnOnPress)       & 1 ) << 2; // mask 0b00000001    
-    regValue |= (((uint8_t)config.AutoLatchOnOffPress)      & 1 ) << 3; // mask 0b00000001    
-    _i2c_writeByte(0x05, regValue);
+    _i2c_writeByte(0x05, OnOffBTN_encodePowerBehavior(config));
 }
 
 uint16_t 
@@ -273,298 +429,97 @@ HHTronik_OnOffBTN::setOffDelay(uint16_t value)
     _i2c_writeShort(0x08, value);
 }
 
-void 
-HHTronik_OnOffBTN::selectAnimation(OnOffBTN_PowerState state, OnOffBTN_Animation animation)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0a;     // animation_on_state_selection at 0x0a
-    else
-        reg = 0x0d;     // animation_off_state_selection at 0x0d
-
-    _i2c_writeByte(reg, (uint8_t)animation);
-}
+bool 
+HHTronik_OnOffBTN::applyProfile(const OnOffBTN_ConfigurationProfile &profile)
+{
+    uint8_t wanted[ONOFFBTN_CONFIG_LENGTH];
+    uint8_t current[ONOFFBTN_CONFIG_LENGTH];
+    bool configChanged = false;
+    bool rtcChanged = false;
+
+    // registers 0x02 - 0x10 as they should be
+    wanted[0]  = profile.LongPressThreshold >> 8;                           // 0x02
+    wanted[1]  = profile.LongPressThreshold & 0xff;                         // 0x03
+    wanted[2]  = OnOffBTN_encodeHardResetBehavior(profile.HardResetBehavior); // 0x04
+    wanted[3]  = OnOffBTN_encodePowerBehavior(profile.PowerBehavior);      // 0x05
+    wanted[4]  = profile.OnDelay >> 8;                                      // 0x06
+    wanted[5]  = profile.OnDelay & 0xff;                                    // 0x07
+    wanted[6]  = profile.OffDelay >> 8;                                     // 0x08
+    wanted[7]  = profile.OffDelay & 0xff;                                   // 0x09
+    wanted[8]  = (uint8_t)profile.OnAnimation;                              // 0x0a
+    wanted[9]  = profile.OnAnimationSpeed;                                  // 0x0b
+    wanted[10] = profile.OnAnimationConfiguration;                          // 0x0c
+    wanted[11] = (uint8_t)profile.OffAnimation;                             // 0x0d
+    wanted[12] = profile.OffAnimationSpeed;                                 // 0x0e
+    wanted[13] = profile.OffAnimationConfiguration;                         // 0x0f
+    wanted[14] = OnOffBTN_encodeFramebufferRestore(profile.RestoreOnFramebuffer, profile.RestoreOffFramebuffer); // 0x10
+
+    if(_i2c_readBytes(ONOFFBTN_CONFIG_FIRST_REGISTER, current, ONOFFBTN_CONFIG_LENGTH) == ONOFFBTN_CONFIG_LENGTH)
+    {
+        // 0x10 bits 2-7 are commands, only the restore behavior is configuration
+        current[14] &= 3;
 
-OnOffBTN_Animation 
-HHTronik_OnOffBTN::getSelectedAnimation(OnOffBTN_PowerState state)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0a;     // animation_on_state_selection at 0x0a
-    else
-        reg = 0x0d;     // animation_off_state_selection at 0x0d
-    
-    return (OnOffBTN_Animation)_i2c_readByte(reg);
-}
+        // 16 bit registers (0x02, 0x06, 0x08) are written as a unit: when
+        // one byte differs, have both sent in the same burst
+        static const uint8_t shorts[] = { 0, 4, 6 };
 
-void 
-HHTronik_OnOffBTN::setAnimationSpeed(OnOffBTN_PowerState state, uint8_t tickSpeed)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0b;     // animation_on_state_tickspeed at 0x0b
-    else
-        reg = 0x0e;     // animation_off_state_tickspeed at 0x0e
+        for(uint8_t s = 0; s < sizeof(shorts); s++)
+        {
+            uint8_t i = shorts[s];
 
-    _i2c_writeByte(reg, tickSpeed);
-}
+            if(current[i] != wanted[i] || current[i + 1] != wanted[i + 1])
+            {
+                current[i] = ~wanted[i];
+                current[i + 1] = ~wanted[i + 1];
+            }
+        }
 
-uint8_t 
-HHTronik_OnOffBTN::getAnimationSpeed(OnOffBTN_PowerState state)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0b;     // animation_on_state_tickspeed at 0x0b
+        configChanged = _i2c_writeChanged(ONOFFBTN_CONFIG_FIRST_REGISTER, current, wanted, ONOFFBTN_CONFIG_LENGTH) > 0;
+    }
     else
-        reg = 0x0e;     // animation_off_state_tickspeed at 0x0e
-    
-    return _i2c_readByte(reg);
-}
+    {
+        _i2c_writeBytes(ONOFFBTN_CONFIG_FIRST_REGISTER, wanted, ONOFFBTN_CONFIG_LENGTH);
+        configChanged = true;
+    }
 
-void 
-HHTronik_OnOffBTN::setAnimationConfiguration(OnOffBTN_PowerState state, uint8_t value)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0c;     // animation_on_state_configuration at 0x0c
-    else
-        reg = 0x0f;     // animation_off_state_configuration at 0x0f
+#if ONOFFBTN_ENABLE_RTC
+    // RTC control and alarm registers 0xb0 - 0xbb, the date/time in between is left alone
+    uint8_t rtc[ONOFFBTN_RTC_LENGTH];
+    bool rtcRead = _i2c_readBytes(ONOFFBTN_RTC_FIRST_REGISTER, rtc, ONOFFBTN_RTC_LENGTH) == ONOFFBTN_RTC_LENGTH;
 
-    _i2c_writeByte(reg, value);
-}
+    uint8_t alarm[4];
+    alarm[0] = OnOffBTN_encodeAlarmComponent(profile.AlarmTime.Seconds, profile.AlarmTime.MaskSeconds, ONOFFBTN_RTC_MAX_SECONDS); // 0xb8
+    alarm[1] = OnOffBTN_encodeAlarmComponent(profile.AlarmTime.Minutes, profile.AlarmTime.MaskMinutes, ONOFFBTN_RTC_MAX_MINUTES); // 0xb9
+    alarm[2] = OnOffBTN_encodeAlarmComponent(profile.AlarmTime.Hours,   profile.AlarmTime.MaskHours,   ONOFFBTN_RTC_MAX_HOURS);   // 0xba
+    alarm[3] = OnOffBTN_encodeAlarmDayDate(profile.AlarmDayDate);                                       // 0xbb
 
-uint8_t 
-HHTronik_OnOffBTN::getAnimationConfiguration(OnOffBTN_PowerState state)
-{
-    uint8_t reg;
-    if(state == PowerOn)
-        reg = 0x0c;     // animation_on_state_configuration at 0x0c
+    if(rtcRead)
+    {
+        rtcChanged = _i2c_writeChanged(0xb8, rtc + 8, alarm, 4) > 0;
+    }
     else
-        reg = 0x0f;     // animation_off_state_configuration at 0x0f
-    
-    return _i2c_readByte(reg);
-}
-
-void 
-HHTronik_OnOffBTN::saveAnimationFramebuffer(OnOffBTN_PowerState state)
-{
-    uint8_t value = 1 << 2;
-
-    if(state == PowerOff)
-        value = 1 << 3;
-
-    _i2c_writeByte(0x10, value);
-}
-
-void 
-HHTronik_OnOffBTN::clearStoredAnimationFramebuffer(OnOffBTN_PowerState state)
-{
-    uint8_t value = 1 << 4;
-
-    if(state == PowerOff)
-        value = 1 << 5;
-
-    _i2c_writeByte(0x10, value);
-}
-
-void 
-HHTronik_OnOffBTN::restoreStoredAnimationFramebuffer(OnOffBTN_PowerState state)
-{
-    uint8_t value = 1 << 6;
-
-    if(state == PowerOff)
-        value = 1 << 7;
-
-    _i2c_writeByte(0x10, value);
-}
-
-void 
-HHTronik_OnOffBTN::setFramebufferRestoreBehavior(bool restoreOnState, bool restoreOffState)
-{
-    uint8_t value = 0;
-
-    if(restoreOnState)
-        value |= 1 << 0;
-
-    if(restoreOnState)
-        value |= 1 << 1;
-
-    _i2c_writeByte(0x10, value);
-}
-
-uint8_t 
-HHTronik_OnOffBTN::getUserEEPROMByte(uint8_t byteIndex)
-{
-    if(byteIndex > 15) return 255;  // we have 16 bytes of storage for the user
-    
-    return _i2c_readByte(0x30 + byteIndex);
-}
-
-void 
-HHTronik_OnOffBTN::setUserEEPROMByte(uint8_t byteIndex, uint8_t value)
-{
-    if(byteIndex > 15) return;  // we have 16 bytes of storage for the user
-    
-    _i2c_writeByte(0x30 + byteIndex, value);
-}
-
-OnOffBTN_RTCControlRegister 
-HHTronik_OnOffBTN::getRTCConfiguration( void )
-{
-    int rawValue = _i2c_readByte(0xb0);     // BUTTON STATUS register at 0x00
-    
-    OnOffBTN_RTCControlRegister result =
     {
-        .AlarmEnabled           = (rawValue >> 0) & 1,
-        .AlarmAction            = (OnOffBTN_RTCAlarmAction)((rawValue >> 1) & 3), // 2 bits
-        .AlarmAutoRearm         = (rawValue >> 3) & 1,
-        .UseAmPmFormat          = (rawValue >> 4) & 1,
-        .AlarmCancelationDelay  = (OnOffBTN_DelayValue)((rawValue >> 5) & 3) // 2 bits again     
-    };
-
-    return result;
-}
-
-void 
-HHTronik_OnOffBTN::setRTCConfiguration(OnOffBTN_RTCControlRegister configuration)
-{
-    uint8_t value = 0;
-
-    value |= (((uint8_t)configuration.AlarmEnabled)          & 1) << 0; // 1 bit
-    value |= (((uint8_t)configuration.AlarmAction)           & 3) << 1; // 2 bits
-    value |= (((uint8_t)configuration.AlarmAutoRearm)        & 1) << 3; // 1 bit
-    value |= (((uint8_t)configuration.UseAmPmFormat)         & 1) << 4; // 1 bit
-    value |= (((uint8_t)configuration.AlarmCancelationDelay) & 3) << 5; // 2 bits
-
-    _i2c_writeByte(0xb0, value);
-}
-
-#define OOB_DATETIMELENGTH (7)
-
-OnOffBTN_DateTime 
-HHTronik_OnOffBTN::getDateTime( void )
-{
-    uint8_t i = 0;
-    uint8_t bytesRcv[OOB_DATETIMELENGTH];
-
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xb1);                       // select register 0xb1 (RTC seconds)
-    Wire.endTransmission(false);            // end write, but don't send STOP condition
-    Wire.requestFrom(i2c_addr, (uint8_t)OOB_DATETIMELENGTH);
-
-    // read the 7 bytes
-    while(Wire.available() > 0 && i <= OOB_DATETIMELENGTH)
-        bytesRcv[i++] = Wire.read();
-
-    OnOffBTN_DateTime result;
-    result.Seconds = bcdToDec(bytesRcv[0]);
-    result.Minutes = bcdToDec(bytesRcv[1]);
-    result.Hours = bcdToDec(bytesRcv[2]);
-    result.DayOfMonth = bcdToDec(bytesRcv[3]);
-    result.Month = bcdToDec(bytesRcv[4]);
-    result.Year = bcdToDec(bytesRcv[5]);
-    result.DayOfWeek = bytesRcv[6];         // this one's not BCD coded!
-
-    return result;
-}
-
-void 
-HHTronik_OnOffBTN::setDateTime(OnOffBTN_DateTime datetime)
-{
-    uint8_t bytesSnd[OOB_DATETIMELENGTH];
-    bytesSnd[0] = decToBcd(datetime.Seconds);
-    bytesSnd[1] = decToBcd(datetime.Minutes);
-    bytesSnd[2] = decToBcd(datetime.Hours);
-    bytesSnd[3] = decToBcd(datetime.DayOfMonth);
-    bytesSnd[4] = decToBcd(datetime.Month);
-    bytesSnd[5] = decToBcd(datetime.Year);
-    bytesSnd[6] = datetime.DayOfWeek & 7;   // not bcd coded, 3 bits
-
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xb1);                       // select register 0xb1 (RTC seconds)
-
-    for(uint8_t i = 0; i < OOB_DATETIMELENGTH; i++) 
-        Wire.write(bytesSnd[i]);
-
-    Wire.endTransmission();                 // done.
-}
-
-#define OOB_ALARMTIMELENGTH (3)
-#define OOB_ALARMDAYDATELENGTH (1)
-
-OnOffBTN_AlarmTime 
-HHTronik_OnOffBTN::getAlarmTime( void )
-{
-    uint8_t i = 0;
-    uint8_t bytesRcv[OOB_ALARMTIMELENGTH];
-
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xb8);                       // select register 0xb8 (RTC ALMAR1)
-    Wire.endTransmission(false);            // end write, but don't send STOP condition
-    Wire.requestFrom(i2c_addr, (uint8_t)OOB_ALARMTIMELENGTH);
-
-    // read the 4 bytes
-    while(Wire.available() > 0 && i <= OOB_ALARMTIMELENGTH)
-        bytesRcv[i++] = Wire.read();
-
-    OnOffBTN_AlarmTime result;
-    result.Seconds      = bcdToDec(bytesRcv[0] & 127);  // 0b01111111 / 1st bis is MaskSeconds 
-    result.Minutes      = bcdToDec(bytesRcv[1] & 127);  // 0b01111111 / 1st bis is MaskMinutes 
-    result.Hours        = bcdToDec(bytesRcv[2] & 127);  // 0b01111111 / 1st bis is Hours     
-    result.MaskSeconds  = (bytesRcv[0] & 128) > 0;      // 0b10000000
-    result.MaskMinutes  = (bytesRcv[1] & 128) > 0;      // 0b10000000
-    result.MaskHours    = (bytesRcv[2] & 128) > 0;      // 0b10000000
-
-    return result;
-}
-
-void
-HHTronik_OnOffBTN::setAlarmTime(OnOffBTN_AlarmTime alarmTime)
-{
-     uint8_t bytesSnd[OOB_ALARMTIMELENGTH];
-    bytesSnd[0] = (decToBcd(alarmTime.Seconds)  & 127) | ((((uint8_t)alarmTime.MaskSeconds) << 7) & 128);
-    bytesSnd[1] = (decToBcd(alarmTime.Minutes)  & 127) | ((((uint8_t)alarmTime.MaskMinutes) << 7) & 128);
-    bytesSnd[2] = (decToBcd(alarmTime.Hours)    & 127) | ((((uint8_t)alarmTime.MaskHours)   << 7) & 128);
-
-    Wire.beginTransmission(i2c_addr);       // send address
-    Wire.write(0xb8);                       // select register 0xb8 (RTC ALMAR1)
-
-    for(uint8_t i = 0; i < OOB_ALARMTIMELENGTH; i++) 
-        Wire.write(bytesSnd[i]);
-
-    Wire.endTransmission();                 // done.
-}
-
-OnOffBTN_AlarmDayDate 
-HHTronik_OnOffBTN::getAlarmDayDate( void )
-{
-    uint8_t almar4 = _i2c_readByte(0xbb);
+        _i2c_writeBytes(0xb8, alarm, 4);
+        rtcChanged = true;
+    }
 
-    OnOffBTN_AlarmDayDate result;
-    result.DayDateMasked  = (bool)((almar4 & 128)   >> 7);
-    result.IsWeekDayAlarm = (bool)((almar4 & 64)    >> 6);
+    // the RTC control register commits itself (~500ms), only touch it when
+    // needed. Nothing may follow the commit until it's done (hosts without
+    // clock stretching would lose the save below).
+    uint8_t rtcControl = OnOffBTN_encodeRTCControl(profile.RTCConfiguration);
+    if(!rtcRead || rtc[0] != rtcControl)
+    {
+        _i2c_writeByte(0xb0, rtcControl);
+        delay(ONOFFBTN_RTC_COMMIT_TIME);
+        rtcChanged = true;
+    }
+#endif
 
-    if(result.IsWeekDayAlarm)
-        result.Value = (almar4 & 7); // 0b00000111 / weekday on 3 bits
-    else
-        result.Value = bcdToDec(almar4 & 63);   // 0b00111111 / bcd coded day of month
+    if(configChanged)
+    {
+        SaveConfiguration();
+        _framebufferValid = false;      // animations may have changed
+    }
 
-    return result;
+    return configChanged || rtcChanged;
 }
-
-void 
-HHTronik_OnOffBTN::setAlarmDayDate(OnOffBTN_AlarmDayDate  value)
-{
-    uint8_t almar4 = 0;
-    
-    almar4 |= ((uint8_t)value.DayDateMasked) << 7;
-    almar4 |= ((uint8_t)value.IsWeekDayAlarm) << 6;
-
-    if(value.IsWeekDayAlarm)
-        almar4 |= (value.Value & 7);            // 0b00000111 / weekday on 3 bits
-    else
-        almar4 |= decToBcd(value.Value & 63);   // 0b00111111 / bcd coded day of month
-
-    
-    _i2c_writeByte(0xbb, almar4);
-}
\ No newline at end of file
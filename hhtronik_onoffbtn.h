@@ -45,9 +45,26 @@
 #endif
 
 #include <Wire.h>
+#include "hhtronik_onoffbtn_config.h"
 
 #define ONOFFBTN_DEFAULT_I2C_ADDRESS        (0x59) 
 #define ONOFFBTN_NUM_PIXELS                 (9)
+#define ONOFFBTN_FRAMEBUFFER_SIZE           (ONOFFBTN_NUM_PIXELS * 3)
+#define ONOFFBTN_USER_EEPROM_SIZE           (16)
+
+// I2C bus clock
+#define ONOFFBTN_BUS_CLOCK_DEFAULT          (400000)    // fast mode
+#define ONOFFBTN_BUS_ERROR_LIMIT            (3)         // failed transfers in a row before stepping the clock down
+#define ONOFFBTN_BUS_RECOVERY_LIMIT         (1000)      // good transfers in a row before stepping it up again
+#define ONOFFBTN_BUS_PROBE_ROUNDS           (8)         // read-backs per rate in negotiateBusClock()
+
+// bits of the raw BUTTON STATUS register (0x00)
+#define ONOFFBTN_STATUS_DOWN                (1 << 0)
+#define ONOFFBTN_STATUS_SHORTPRESS          (1 << 1)
+#define ONOFFBTN_STATUS_LONGPRESS           (1 << 2)
+#define ONOFFBTN_STATUS_DOUBLECLICK         (1 << 3)
+#define ONOFFBTN_STATUS_POWERON             (1 << 4)
+#define ONOFFBTN_STATUS_RTCALARM            (1 << 5)
 
 typedef enum {
   delay100ms = 0,
@@ -144,6 +161,181 @@ typedef struct
   bool DayDateMasked  : 1;
 } OnOffBTN_AlarmDayDate;
 
+/**
+ * A full device configuration, see HHTronik_OnOffBTN::applyProfile().
+ * Every register the driver writes is covered, so a profile can be declared
+ * as a (constexpr) global per product variant.
+ */
+typedef struct
+{
+  uint16_t LongPressThreshold;
+  OnOffBTN_HardResetBehaviorRegister HardResetBehavior;
+  OnOffBTN_PowerBehaviorRegister PowerBehavior;
+  uint16_t OnDelay;
+  uint16_t OffDelay;
+  OnOffBTN_Animation OnAnimation;
+  uint8_t OnAnimationSpeed;
+  uint8_t OnAnimationConfiguration;
+  OnOffBTN_Animation OffAnimation;
+  uint8_t OffAnimationSpeed;
+  uint8_t OffAnimationConfiguration;
+  bool RestoreOnFramebuffer;
+  bool RestoreOffFramebuffer;
+  OnOffBTN_RTCControlRegister RTCConfiguration;
+  OnOffBTN_AlarmTime AlarmTime;
+  OnOffBTN_AlarmDayDate AlarmDayDate;
+} OnOffBTN_ConfigurationProfile;
+
+// configuration registers 0x02 (long press threshold) to 0x10 (framebuffer control)
+#define ONOFFBTN_CONFIG_FIRST_REGISTER      (0x02)
+#define ONOFFBTN_CONFIG_LENGTH              (15)
+
+// configuration registers + User-EEPROM, see negotiateBusClock()
+#define ONOFFBTN_BUS_PROBE_SIZE             (ONOFFBTN_CONFIG_LENGTH + ONOFFBTN_USER_EEPROM_SIZE)
+
+// RTC registers 0xb0 (control) to 0xbb (ALMAR4)
+#define ONOFFBTN_RTC_FIRST_REGISTER         (0xb0)
+#define ONOFFBTN_RTC_LENGTH                 (12)
+#define ONOFFBTN_RTC_COMMIT_TIME            (500)       // ms, see setRTCConfiguration()
+
+/////////////////////////////////////////////////////////
+// Register encoding / decoding
+
+/**
+ * convert a decimal number to a bcd encoded value, values above 99 saturate
+ * (the result always is valid BCD)
+ */
+constexpr uint8_t OnOffBTN_decToBcd(uint8_t val) { return val > 99 ? 0x99 : (uint8_t)((val / 10 * 16) + (val % 10)); }
+
+/**
+ * convert a BCD encoded value to a decimal
+ */
+constexpr uint8_t OnOffBTN_bcdToDec(uint8_t val) { return (uint8_t)((val / 16 * 10) + (val % 16)); }
+
+// upper bounds of the BCD coded RTC fields, values above saturate
+#define ONOFFBTN_RTC_MAX_SECONDS            (59)
+#define ONOFFBTN_RTC_MAX_MINUTES            (59)
+#define ONOFFBTN_RTC_MAX_HOURS              (23)
+#define ONOFFBTN_RTC_MAX_DAY_OF_MONTH       (31)
+#define ONOFFBTN_RTC_MAX_MONTH              (12)
+#define ONOFFBTN_RTC_MAX_YEAR               (99)
+
+/**
+ * convert a decimal number to the BCD coded value of a field that ranges
+ * up to max (see ONOFFBTN_RTC_MAX_*), values above saturate at max
+ */
+constexpr uint8_t OnOffBTN_encodeBcdField(uint8_t val, uint8_t max) { return OnOffBTN_decToBcd(val > max ? max : val); }
+
+// hard reset behavior register (0x04)
+constexpr uint8_t OnOffBTN_encodeHardResetBehavior(OnOffBTN_HardResetBehaviorRegister config)
+{
+  return (uint8_t)(
+      ((((uint8_t)config.DisableHardReset)      & 1  ) << 0)    // mask 0b00000001
+    | ((((uint8_t)config.HardResetHoldDuration) & 15 ) << 1)    // mask 0b00001111
+    | ((((uint8_t)config.AutoRestartAfterReset) & 1  ) << 5)    // mask 0b00000001
+    | ((((uint8_t)config.AutoRestartDelay)      & 3  ) << 6));  // mask 0b00000011
+}
+
+constexpr OnOffBTN_HardResetBehaviorRegister OnOffBTN_decodeHardResetBehavior(uint8_t regValue)
+{
+  return OnOffBTN_HardResetBehaviorRegister {
+    (bool)((regValue & 1)   >> 0),                    // mask 0b00000001
+    (uint8_t)((regValue & 30)  >> 1),                 // mask 0b00011110
+    (bool)((regValue & 32)  >> 5),                    // mask 0b00100000
+    (OnOffBTN_DelayValue)((regValue & 192) >> 6)      // mask 0b11000000
+  };
+}
+
+// power behavior register (0x05)
+constexpr uint8_t OnOffBTN_encodePowerBehavior(OnOffBTN_PowerBehaviorRegister config)
+{
+  return (uint8_t)(
+      ((((uint8_t)config.PoR_DefaultOn)            & 1 ) << 0)  // mask 0b00000001
+    | ((((uint8_t)config.PoR_RestoreFramebuffer)   & 1 ) << 1)  // mask 0b00000001
+    | ((((uint8_t)config.AutoLatchOnOnPress)       & 1 ) << 2)  // mask 0b00000001
+    | ((((uint8_t)config.AutoLatchOnOffPress)      & 1 ) << 3)); // mask 0b00000001
+}
+
+constexpr OnOffBTN_PowerBehaviorRegister OnOffBTN_decodePowerBehavior(uint8_t regValue)
+{
+  return OnOffBTN_PowerBehaviorRegister {
+    (bool)((regValue & 1)   >> 0),                    // mask 0b00000001
+    (bool)((regValue & 2)   >> 1),                    // mask 0b00000010
+    (bool)((regValue & 4)   >> 2),                    // mask 0b00000100
+    (bool)((regValue & 8)   >> 3)                     // mask 0b00001000
+  };
+}
+
+// framebuffer restore behavior bits of the framebuffer control register (0x10)
+constexpr uint8_t OnOffBTN_encodeFramebufferRestore(bool restoreOnState, bool restoreOffState)
+{
+  return (uint8_t)((((uint8_t)restoreOnState) << 0) | (((uint8_t)restoreOffState) << 1));
+}
+
+// RTC control register (0xb0)
+constexpr uint8_t OnOffBTN_encodeRTCControl(OnOffBTN_RTCControlRegister configuration)
+{
+  return (uint8_t)(
+      ((((uint8_t)configuration.AlarmEnabled)          & 1) << 0)   // 1 bit
+    | ((((uint8_t)configuration.AlarmAction)           & 3) << 1)   // 2 bits
+    | ((((uint8_t)configuration.AlarmAutoRearm)        & 1) << 3)   // 1 bit
+    | ((((uint8_t)configuration.UseAmPmFormat)         & 1) << 4)   // 1 bit
+    | ((((uint8_t)configuration.AlarmCancelationDelay) & 3) << 5)); // 2 bits
+}
+
+constexpr OnOffBTN_RTCControlRegister OnOffBTN_decodeRTCControl(uint8_t rawValue)
+{
+  return OnOffBTN_RTCControlRegister {
+    (bool)((rawValue >> 0) & 1),
+    (OnOffBTN_RTCAlarmAction)((rawValue >> 1) & 3),   // 2 bits
+    (bool)((rawValue >> 3) & 1),
+    (bool)((rawValue >> 4) & 1),
+    (OnOffBTN_DelayValue)((rawValue >> 5) & 3)        // 2 bits again
+  };
+}
+
+// one of the alarm time registers (ALMAR1-3 at 0xb8-0xba): bit 7 masks the BCD coded value,
+// values above max (ONOFFBTN_RTC_MAX_SECONDS/MINUTES/HOURS) saturate
+constexpr uint8_t OnOffBTN_encodeAlarmComponent(uint8_t value, bool masked, uint8_t max)
+{
+  return (uint8_t)(OnOffBTN_encodeBcdField(value, max) | ((((uint8_t)masked) << 7) & 128));
+}
+
+constexpr OnOffBTN_AlarmTime OnOffBTN_decodeAlarmTime(uint8_t almar1, uint8_t almar2, uint8_t almar3)
+{
+  return OnOffBTN_AlarmTime {
+    OnOffBTN_bcdToDec(almar1 & 127),                  // 0b01111111 / 1st bit is MaskSeconds
+    OnOffBTN_bcdToDec(almar2 & 127),                  // 0b01111111 / 1st bit is MaskMinutes
+    OnOffBTN_bcdToDec(almar3 & 127),                  // 0b01111111 / 1st bit is MaskHours
+    (almar1 & 128) > 0,                               // 0b10000000
+    (almar2 & 128) > 0,                               // 0b10000000
+    (almar3 & 128) > 0                                // 0b10000000
+  };
+}
+
+// alarm week-day/date register (ALMAR4 at 0xbb)
+constexpr uint8_t OnOffBTN_encodeAlarmDayDate(OnOffBTN_AlarmDayDate value)
+{
+  return (uint8_t)(
+      (((uint8_t)value.DayDateMasked) << 7)
+    | (((uint8_t)value.IsWeekDayAlarm) << 6)
+    | (value.IsWeekDayAlarm
+        ? (value.Value & 7)                           // 0b00000111 / weekday on 3 bits
+        : OnOffBTN_encodeBcdField(value.Value,         // 0b00111111 / bcd coded day of month
+            ONOFFBTN_RTC_MAX_DAY_OF_MONTH)));
+}
+
+constexpr OnOffBTN_AlarmDayDate OnOffBTN_decodeAlarmDayDate(uint8_t almar4)
+{
+  return OnOffBTN_AlarmDayDate {
+    (uint8_t)(((almar4 & 64) >> 6)
+      ? (almar4 & 7)                                  // 0b00000111 / weekday on 3 bits
+      : OnOffBTN_bcdToDec(almar4 & 63)),              // 0b00111111 / bcd coded day of month
+    (bool)((almar4 & 64) >> 6),
+    (bool)((almar4 & 128) >> 7)
+  };
+}
+
 
 class HHTronik_OnOffBTN {
  public:
@@ -163,6 +355,50 @@ class HHTronik_OnOffBTN {
    */
   boolean begin(uint8_t sdaPin, uint8_t sclPin, uint8_t addr = ONOFFBTN_DEFAULT_I2C_ADDRESS);
 
+  /**
+   * Find the fastest bus clock the ÖnÖffBTN can be used at reliably. 1MHz
+   * (Fast-mode Plus) and 400kHz are tried in turn: at each rate, for
+   * ONOFFBTN_BUS_PROBE_ROUNDS rounds, the configuration registers and the
+   * User-EEPROM are read back and compared to a reference read at 100kHz,
+   * and a test pattern is written to the framebuffer and read back (erased
+   * or zeroed registers can't show bit errors). The framebuffer is restored
+   * afterwards.
+   * 
+   * @note call it while no animation is running: an animation changing the
+   * framebuffer makes the faster rates fail
+   * @note the clock is shared by every device on the bus, use maxClock if
+   * some of them don't support the faster rates
+   * @param maxClock highest clock to try (Hz)
+   * @returns the selected clock (Hz), 100000 if no faster rate was reliable
+   */
+  uint32_t negotiateBusClock(uint32_t maxClock = 1000000);
+
+  /**
+   * Set the bus clock (Hz). The driver steps the clock down by itself
+   * (1MHz > 400kHz > 100kHz) after ONOFFBTN_BUS_ERROR_LIMIT failed
+   * transfers in a row, and back up towards the clock set here after
+   * ONOFFBTN_BUS_RECOVERY_LIMIT good transfers in a row.
+   * 
+   * @note Wire has a single clock: it is shared by every instance of the
+   * driver (several ÖnÖffBTNs on the bus), as are the step down/up. begin()
+   * keeps the current clock.
+   */
+  static void setBusClock(uint32_t clock);
+
+  /**
+   * Current bus clock (Hz), the same for every instance
+   */
+  static uint32_t getBusClock( void ) { return _busClock; }
+
+  /**
+   * Number of failed transfers (NACK or short read) of this device since the
+   * last reset
+   */
+  uint16_t getBusErrorCount( void ) { return _busErrors; }
+
+  void resetBusErrorCount( void ) { _busErrors = 0; }
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
   /**
    * Set all pixels to black
    */
@@ -189,6 +425,42 @@ class HHTronik_OnOffBTN {
   */  
   void setPixels(const uint8_t *subpixel, const uint8_t length, const uint8_t offset = 0);
 
+  /**
+    Send a full frame to the ÖnÖffBTN, but only the subpixels that differ from
+    what the framebuffer currently holds. The driver keeps a copy of the framebuffer
+    for that purpose; when the copy can't be trusted anymore (after restoring a
+    stored framebuffer, selecting an animation, a power state change or a
+    failed transfer) it is read back from the device first.
+  
+    @param frame ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+    @returns the number of subpixels sent
+  */
+  uint8_t updateFramebuffer(const uint8_t *frame);
+
+  /**
+    Read the framebuffer from the ÖnÖffBTN (single burst) and
+    resynchronize the driver's copy.
+  
+    @param frame (optional) destination buffer of ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+    @returns true if the whole framebuffer could be read
+  */
+  bool readFramebuffer(uint8_t *frame = NULL);
+
+  /**
+    Get the driver's copy of the framebuffer, it is read back from the
+    device first if needed.
+  
+    @returns a pointer to ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+  */
+  const uint8_t *getFramebuffer( void );
+
+  /**
+    Mark the driver's copy of the framebuffer as out of date, use this when
+    the framebuffer was changed by other means than this driver
+  */
+  void invalidateFramebuffer( void ) { _framebufferValid = false; }
+#endif
+
   /**
    * Get the button status
    * @param pollMode (default true) use register 0x50 instead of 0x00 to not reset flags 
@@ -197,6 +469,12 @@ class HHTronik_OnOffBTN {
    */
   OnOffBTN_StatusRegister getButtonStatus();
 
+  /**
+   * Get the button status as the raw register byte, see the
+   * ONOFFBTN_STATUS_* bit masks
+   */
+  uint8_t getRawButtonStatus( void );
+
 
   /**
    * Persist the current configuration to EEPROM.
@@ -283,6 +561,7 @@ class HHTronik_OnOffBTN {
    */
   void setOffDelay(uint16_t value);
 
+#if ONOFFBTN_ENABLE_ANIMATION
   /**
    * Select the animation used for the specified power state
    * @param state On or Off state
@@ -348,7 +627,9 @@ class HHTronik_OnOffBTN {
    * framebuffer when the button latches to "off"
    */
   void setFramebufferRestoreBehavior(bool restoreOnState, bool restoreOffState);
+#endif
 
+#if ONOFFBTN_ENABLE_USER_EEPROM
   /**
    * Read a persisted byte from the EEPROM
    * 
@@ -365,6 +646,30 @@ class HHTronik_OnOffBTN {
    */
   void setUserEEPROMByte(uint8_t byteIndex, uint8_t value);
 
+  /**
+   * Read a block of the user EEPROM in a single I2C transfer
+   * 
+   * @param offset index of the first byte to read
+   * @param buffer destination buffer, at least length bytes
+   * @param length number of bytes to read (clipped to the EEPROM size)
+   * @returns the number of bytes read
+   */
+  uint8_t readUserEEPROM(uint8_t offset, uint8_t *buffer, uint8_t length);
+
+  /**
+   * Write a block of the user EEPROM. The current content is read first and
+   * only the bytes that actually differ are written (in bursts), so unchanged
+   * cells are not worn.
+   * 
+   * @param offset index of the first byte to write
+   * @param buffer data to write
+   * @param length number of bytes to write (clipped to the EEPROM size)
+   * @returns the number of bytes that had to be written
+   */
+  uint8_t writeUserEEPROM(uint8_t offset, const uint8_t *buffer, uint8_t length);
+#endif
+
+#if ONOFFBTN_ENABLE_RTC
   /**
    * Read the RTC configuration
    */
@@ -408,10 +713,48 @@ class HHTronik_OnOffBTN {
    * Set the RTC alarm week-day/date configuration
    */ 
   void setAlarmDayDate(OnOffBTN_AlarmDayDate  value);
+#endif
+
+  /**
+   * Bring the device configuration in line with a profile. The current
+   * configuration is read in two bursts, only registers that differ are
+   * written (16 bit registers always both bytes in one transfer) and the
+   * configuration is only persisted (SaveConfiguration(), ~500ms) when
+   * something actually changed.
+   * 
+   * @note changing the RTC configuration takes up to 500ms as well, see
+   * setRTCConfiguration(): applyProfile() waits ONOFFBTN_RTC_COMMIT_TIME
+   * after it so the commit isn't disturbed by the save. The RTC part of the
+   * profile is ignored when the RTC unit is disabled (ONOFFBTN_ENABLE_RTC)
+   * 
+   * @param profile the wanted configuration
+   * @returns true if the device configuration had to be changed
+   */
+  bool applyProfile(const OnOffBTN_ConfigurationProfile &profile);
 
  private:
+  friend class HHTronik_OnOffBTN_Group;
+  friend class HHTronik_OnOffBTN_Watchdog;
+  friend class HHTronik_OnOffBTN_BusOwner;
+  friend class HHTronik_OnOffBTN_Scheduler;
+
   uint8_t i2c_addr;
 
+  uint8_t _lastStatus;
+  bool _framebufferValid;
+
+  // the bus (Wire) is shared by every instance
+  static uint32_t _busClock;
+  static uint32_t _busClockTarget;  // set by setBusClock(), stepping up stops there
+  static uint8_t _busErrorStreak;
+  static uint16_t _busGoodStreak;
+
+  uint16_t _busErrors;
+  bool _lastTransferOk;       // result of the last transfer, see _i2c_result()
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+  uint8_t _framebuffer[ONOFFBTN_FRAMEBUFFER_SIZE];
+#endif
+
   uint8_t _i2c_readByte(uint8_t reg);
   void _i2c_writeByte(uint8_t reg, uint8_t value);
 
@@ -419,15 +762,24 @@ class HHTronik_OnOffBTN {
   uint16_t _i2c_readShort(uint8_t reg);
   void _i2c_writeShort(uint8_t reg, uint16_t value);
 
+  uint8_t _i2c_readBytes(uint8_t reg, uint8_t *buffer, uint8_t length);
+  void _i2c_writeBytes(uint8_t reg, const uint8_t *buffer, uint8_t length);
+  uint8_t _i2c_writeChanged(uint8_t reg, const uint8_t *current, const uint8_t *wanted, uint8_t length, uint8_t mergeGap = 0);   // _lastTransferOk: all bursts
+
+  void _i2c_result(bool ok);
+  static void _applyBusClock(uint32_t clock);
+  uint8_t _readBusProbe(uint8_t *buffer);
+  bool _busRoundTrip(uint8_t round);
+
   /**
    * convert a decimal number to a bcd encoded value
    */
-  uint8_t decToBcd(uint8_t val) { return((val / 10 * 16) + (val % 10)); }
+  uint8_t decToBcd(uint8_t val) { return OnOffBTN_decToBcd(val); }
 
   /**
    * convert a BCD encoded value to a decimal
    */
-  uint8_t bcdToDec(uint8_t val) { return((val / 16 * 10) + (val % 16)); }
+  uint8_t bcdToDec(uint8_t val) { return OnOffBTN_bcdToDec(val); }
 };
 
 #endif
@@ -0,0 +1,133 @@
+/**
+    @file     hhtronik_onoffbtn_animation.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Arduino driver for the HHTronik ÖnÖffBTN: animation configuration and stored framebuffers.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_ANIMATION
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void 
+HHTronik_OnOffBTN::selectAnimation(OnOffBTN_PowerState state, OnOffBTN_Animation animation)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0a;     // animation_on_state_selection at 0x0a
+    else
+        reg = 0x0d;     // animation_off_state_selection at 0x0d
+
+    _i2c_writeByte(reg, (uint8_t)animation);
+
+    // firmware animations change the framebuffer behind our back
+    if(animation != Animation_None)
+        _framebufferValid = false;
+}
+
+OnOffBTN_Animation 
+HHTronik_OnOffBTN::getSelectedAnimation(OnOffBTN_PowerState state)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0a;     // animation_on_state_selection at 0x0a
+    else
+        reg = 0x0d;     // animation_off_state_selection at 0x0d
+    
+    return (OnOffBTN_Animation)_i2c_readByte(reg);
+}
+
+void 
+HHTronik_OnOffBTN::setAnimationSpeed(OnOffBTN_PowerState state, uint8_t tickSpeed)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0b;     // animation_on_state_tickspeed at 0x0b
+    else
+        reg = 0x0e;     // animation_off_state_tickspeed at 0x0e
+
+    _i2c_writeByte(reg, tickSpeed);
+}
+
+uint8_t 
+HHTronik_OnOffBTN::getAnimationSpeed(OnOffBTN_PowerState state)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0b;     // animation_on_state_tickspeed at 0x0b
+    else
+        reg = 0x0e;     // animation_off_state_tickspeed at 0x0e
+    
+    return _i2c_readByte(reg);
+}
+
+void 
+HHTronik_OnOffBTN::setAnimationConfiguration(OnOffBTN_PowerState state, uint8_t value)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0c;     // animation_on_state_configuration at 0x0c
+    else
+        reg = 0x0f;     // animation_off_state_configuration at 0x0f
+
+    _i2c_writeByte(reg, value);
+}
+
+uint8_t 
+HHTronik_OnOffBTN::getAnimationConfiguration(OnOffBTN_PowerState state)
+{
+    uint8_t reg;
+    if(state == PowerOn)
+        reg = 0x0c;     // animation_on_state_configuration at 0x0c
+    else
+        reg = 0x0f;     // animation_off_state_configuration at 0x0f
+    
+    return _i2c_readByte(reg);
+}
+
+void 
+HHTronik_OnOffBTN::saveAnimationFramebuffer(OnOffBTN_PowerState state)
+{
+    uint8_t value = 1 << 2;
+
+    if(state == PowerOff)
+        value = 1 << 3;
+
+    _i2c_writeByte(0x10, value);
+}
+
+void 
+HHTronik_OnOffBTN::clearStoredAnimationFramebuffer(OnOffBTN_PowerState state)
+{
+    uint8_t value = 1 << 4;
+
+    if(state == PowerOff)
+        value = 1 << 5;
+
+    _i2c_writeByte(0x10, value);
+}
+
+void 
+HHTronik_OnOffBTN::restoreStoredAnimationFramebuffer(OnOffBTN_PowerState state)
+{
+    uint8_t value = 1 << 6;
+
+    if(state == PowerOff)
+        value = 1 << 7;
+
+    _i2c_writeByte(0x10, value);
+    _framebufferValid = false;
+}
+
+void 
+HHTronik_OnOffBTN::setFramebufferRestoreBehavior(bool restoreOnState, bool restoreOffState)
+{
+    _i2c_writeByte(0x10, OnOffBTN_encodeFramebufferRestore(restoreOnState, restoreOffState));
+}
+
+#endif
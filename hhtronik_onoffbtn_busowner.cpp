@@ -0,0 +1,213 @@
+/**
+    @file     hhtronik_onoffbtn_busowner.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Thread-safe access to an ÖnÖffBTN for Linux hosts.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_busowner.h"
+
+#if ONOFFBTN_ENABLE_BUS_OWNER
+
+#include <stdexcept>
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_BusOwner::HHTronik_OnOffBTN_BusOwner(HHTronik_OnOffBTN &btn)
+    : _btn(&btn), _pending(0), _running(true), _merged(0)
+{
+    // the queue always holds a node, the one _tail points to has been consumed
+    Command *stub = new Command();
+    _head.store(stub, std::memory_order_relaxed);
+    _tail = stub;
+
+    _worker = std::thread(&HHTronik_OnOffBTN_BusOwner::_run, this);
+}
+
+HHTronik_OnOffBTN_BusOwner::~HHTronik_OnOffBTN_BusOwner()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeLock);
+        _running.store(false);
+    }
+
+    _wake.notify_one();
+    _worker.join();
+
+    delete _tail;
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+void
+HHTronik_OnOffBTN_BusOwner::_push(Command *command)
+{
+    // wait-free for producers: one exchange, then link the previous node
+    Command *previous = _head.exchange(command, std::memory_order_acq_rel);
+    previous->next.store(command, std::memory_order_release);
+
+    // only the first command after the worker went idle has to wake it up
+    if(_pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    {
+        std::lock_guard<std::mutex> lock(_wakeLock);
+        _wake.notify_one();
+    }
+}
+
+HHTronik_OnOffBTN_BusOwner::Command *
+HHTronik_OnOffBTN_BusOwner::_pop( void )
+{
+    Command *tail = _tail;
+    Command *next = tail->next.load(std::memory_order_acquire);
+
+    // empty, or a producer is between its exchange and the link
+    if(next == nullptr) return nullptr;
+
+    // next becomes the consumed node, its payload is moved out by the caller
+    _tail = next;
+    delete tail;
+
+    return next;
+}
+
+void
+HHTronik_OnOffBTN_BusOwner::_flush(std::vector<PendingWrite> &writes)
+{
+    for(PendingWrite &write : writes)
+    {
+        uint8_t value = write.value;
+        bool ok = true;
+
+        // nothing to keep when every bit is written
+        if(write.mask != 0xff)
+        {
+            value = (_btn->_i2c_readByte(write.reg) & ~write.mask) | (value & write.mask);
+            ok = _btn->_lastTransferOk;
+        }
+
+        // never write a value built from a failed read: it would change the
+        // bits the callers wanted to keep
+        if(ok)
+        {
+            _btn->_i2c_writeByte(write.reg, value);
+            ok = _btn->_lastTransferOk;
+        }
+
+        bool failed = !ok;
+
+        for(std::promise<void> &done : write.done)
+        {
+            if(failed)
+                done.set_exception(std::make_exception_ptr(std::runtime_error("OnOffBTN: bus error")));
+            else
+                done.set_value();
+        }
+    }
+
+    writes.clear();
+}
+
+void
+HHTronik_OnOffBTN_BusOwner::_run( void )
+{
+    std::vector<PendingWrite> writes;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_wakeLock);
+            _wake.wait(lock, [this] { return _pending.load(std::memory_order_acquire) > 0 || !_running.load(); });
+        }
+
+        uint32_t available = _pending.load(std::memory_order_acquire);
+        if(available == 0) break;               // stopped and drained
+
+        for(uint32_t processed = 0; processed < available; )
+        {
+            Command *command = _pop();
+
+            if(command == nullptr)
+            {
+                // counted but not linked yet
+                std::this_thread::yield();
+                continue;
+            }
+
+            processed++;
+
+            if(command->call)
+            {
+                // callables see every update submitted before them
+                _flush(writes);
+                command->call(*_btn);
+                command->call = nullptr;
+                continue;
+            }
+
+            // merge with a pending update of the same register
+            PendingWrite *write = nullptr;
+            for(PendingWrite &pending : writes)
+            {
+                if(pending.reg == command->reg) write = &pending;
+            }
+
+            if(write == nullptr)
+            {
+                writes.push_back(PendingWrite());
+                write = &writes.back();
+                write->reg = command->reg;
+                write->mask = 0;
+                write->value = 0;
+            }
+            else
+            {
+                _merged.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            write->value = (write->value & ~command->mask) | (command->value & command->mask);
+            write->mask |= command->mask;
+            write->done.push_back(std::move(command->done));
+        }
+
+        _flush(writes);
+        _pending.fetch_sub(available, std::memory_order_acq_rel);
+    }
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+std::future<void>
+HHTronik_OnOffBTN_BusOwner::updateField(uint8_t reg, uint8_t mask, uint8_t value)
+{
+    Command *command = new Command();
+    command->reg = reg;
+    command->mask = mask;
+    command->value = value & mask;
+
+    std::future<void> done = command->done.get_future();
+    _push(command);
+    return done;
+}
+
+std::future<void>
+HHTronik_OnOffBTN_BusOwner::updatePowerBehavior(OnOffBTN_PowerBehaviorRegister value, OnOffBTN_PowerBehaviorRegister mask)
+{
+    return updateField(0x05, OnOffBTN_encodePowerBehavior(mask), OnOffBTN_encodePowerBehavior(value));
+}
+
+std::future<void>
+HHTronik_OnOffBTN_BusOwner::updateHardResetBehavior(OnOffBTN_HardResetBehaviorRegister value, OnOffBTN_HardResetBehaviorRegister mask)
+{
+    // a field is selected by any non-zero value, widen it to all its bits
+    if(mask.HardResetHoldDuration) mask.HardResetHoldDuration = 15;
+    if(mask.AutoRestartDelay) mask.AutoRestartDelay = (OnOffBTN_DelayValue)3;
+
+    return updateField(0x04, OnOffBTN_encodeHardResetBehavior(mask), OnOffBTN_encodeHardResetBehavior(value));
+}
+
+#endif
@@ -0,0 +1,160 @@
+/**
+    @file     hhtronik_onoffbtn_busowner.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Thread-safe access to an ÖnÖffBTN for Linux hosts (with a Wire
+    implementation on top of i2c-dev or similar).
+
+    HHTronik_OnOffBTN isn't synchronized: several threads using it would
+    interleave their transfers, and its setters write whole registers, so
+    two threads changing different fields of the same register overwrite
+    each other. The bus owner runs a single worker thread that is the only
+    one touching the driver. Other threads submit commands through a
+    lock-free multi-producer queue and get the results as std::future.
+
+    Field updates (a mask and a value for one register) are read-modify-write
+    operations. Consecutive updates of the same register are merged into a
+    single read and write, even when they come from different threads:
+
+      // thread A                                     // thread B
+      owner.updatePowerBehavior(                      owner.updatePowerBehavior(
+        { .PoR_DefaultOn = true },                      { .AutoLatchOnOffPress = false },
+        { .PoR_DefaultOn = true });                     { .AutoLatchOnOffPress = true });
+
+    Anything else is submitted as a callable, run on the worker thread:
+
+      std::future<uint8_t> status = owner.submit(
+        [](HHTronik_OnOffBTN &btn) { return btn.getRawButtonStatus(); });
+
+    Pending field updates are always written before the next callable runs,
+    so callables see them.
+
+    extras/host/busowner_bench.cpp compares the field update throughput with
+    a driver guarded by a plain std::mutex (run extras/host.sh --bench).
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_BUSOWNER_H_
+#define _HHTRONIK_ONOFFBTN_BUSOWNER_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_BUS_OWNER
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class HHTronik_OnOffBTN_BusOwner {
+ public:
+  /**
+   * @param btn the driver (call begin() on it first), only the worker
+   * thread may use it from now on
+   */
+  HHTronik_OnOffBTN_BusOwner(HHTronik_OnOffBTN &btn);
+
+  /**
+   * Stops the worker, after running the commands already submitted
+   */
+  ~HHTronik_OnOffBTN_BusOwner();
+
+  HHTronik_OnOffBTN_BusOwner(const HHTronik_OnOffBTN_BusOwner &) = delete;
+  HHTronik_OnOffBTN_BusOwner &operator=(const HHTronik_OnOffBTN_BusOwner &) = delete;
+
+  /**
+   * Change the bits selected by mask in a register
+   * @returns a future that is ready once the register was written, it holds
+   * a std::runtime_error if the transfer failed (the register isn't written
+   * at all when reading it failed)
+   */
+  std::future<void> updateField(uint8_t reg, uint8_t mask, uint8_t value);
+
+  /**
+   * Change the fields of the power behavior register (0x05) that are set
+   * in mask
+   */
+  std::future<void> updatePowerBehavior(OnOffBTN_PowerBehaviorRegister value, OnOffBTN_PowerBehaviorRegister mask);
+
+  /**
+   * Change the fields of the hard reset behavior register (0x04) that are
+   * set in mask (HardResetHoldDuration and AutoRestartDelay: any non-zero
+   * value selects the whole field)
+   */
+  std::future<void> updateHardResetBehavior(OnOffBTN_HardResetBehaviorRegister value, OnOffBTN_HardResetBehaviorRegister mask);
+
+  /**
+   * Run a callable taking the driver on the worker thread
+   * @returns a future holding the callable's result (or exception)
+   */
+  template<typename Callable>
+  std::future<typename std::result_of<Callable(HHTronik_OnOffBTN &)>::type> submit(Callable callable)
+  {
+    typedef typename std::result_of<Callable(HHTronik_OnOffBTN &)>::type Result;
+
+    // std::function needs a copyable target
+    std::shared_ptr<std::packaged_task<Result(HHTronik_OnOffBTN &)> > task =
+      std::make_shared<std::packaged_task<Result(HHTronik_OnOffBTN &)> >(callable);
+
+    Command *command = new Command();
+    command->call = [task](HHTronik_OnOffBTN &btn) { (*task)(btn); };
+
+    std::future<Result> result = task->get_future();
+    _push(command);
+    return result;
+  }
+
+  /**
+   * Number of register writes saved by merging field updates so far
+   */
+  uint32_t getMergedCount( void ) { return _merged.load(std::memory_order_relaxed); }
+
+ private:
+  struct Command {
+    std::atomic<Command *> next;
+    uint8_t reg;
+    uint8_t mask;
+    uint8_t value;
+    std::promise<void> done;
+    std::function<void(HHTronik_OnOffBTN &)> call;   // empty for field updates
+
+    Command() : next(nullptr), reg(0), mask(0), value(0) {}
+  };
+
+  struct PendingWrite {
+    uint8_t reg;
+    uint8_t mask;
+    uint8_t value;
+    std::vector<std::promise<void> > done;
+  };
+
+  HHTronik_OnOffBTN *_btn;
+
+  // intrusive MPSC queue: producers swap _head, the worker follows _tail
+  std::atomic<Command *> _head;
+  Command *_tail;
+
+  // wake-up of an idle worker, producers only lock when it may be waiting
+  std::atomic<uint32_t> _pending;
+  std::atomic<bool> _running;
+  std::mutex _wakeLock;
+  std::condition_variable _wake;
+
+  std::atomic<uint32_t> _merged;
+  std::thread _worker;
+
+  void _push(Command *command);
+  Command *_pop( void );
+  void _run( void );
+  void _flush(std::vector<PendingWrite> &writes);
+};
+
+#endif // ONOFFBTN_ENABLE_BUS_OWNER
+
+#endif
@@ -0,0 +1,131 @@
+/**
+    @file     hhtronik_onoffbtn_codec_check.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Compile-time verification of the register codecs (see hhtronik_onoffbtn.h).
+
+    Every register value (and every in-range field value) is round-tripped
+    through its encode/decode pair by the compiler: a codec change that loses
+    a bit, lets a field spill into a neighbouring one or produces invalid BCD
+    or an out-of-range time/date breaks the build of the library. This unit
+    generates no code. extras/host/registers_test.cpp covers the transfers
+    (setter/getter pairs against a simulated device).
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+
+namespace {
+
+// true if Check holds for every value in [from, to), split in halves to keep
+// the recursion depth (and compile time) low
+template<bool (*Check)(uint8_t)>
+constexpr bool forAll(uint16_t from, uint16_t to)
+{
+  return to - from == 1
+    ? Check((uint8_t)from)
+    : forAll<Check>(from, (from + to) / 2) && forAll<Check>((from + to) / 2, to);
+}
+
+constexpr bool isBcd(uint8_t raw) { return (raw >> 4) <= 9 && (raw & 15) <= 9; }
+
+/////////////////////////////////////////////////////////
+// BCD
+
+constexpr bool bcdFromDecimal(uint8_t val)
+{
+  return isBcd(OnOffBTN_decToBcd(val))
+    && (val > 99 ? OnOffBTN_decToBcd(val) == 0x99 : OnOffBTN_bcdToDec(OnOffBTN_decToBcd(val)) == val);
+}
+
+constexpr bool bcdFromRegister(uint8_t raw)
+{
+  return !isBcd(raw) || OnOffBTN_decToBcd(OnOffBTN_bcdToDec(raw)) == raw;
+}
+
+constexpr bool bcdField(uint8_t val)
+{
+  // every RTC field saturates at its own upper bound
+  return OnOffBTN_bcdToDec(OnOffBTN_encodeBcdField(val, ONOFFBTN_RTC_MAX_SECONDS)) == (val > 59 ? 59 : val)
+    && OnOffBTN_bcdToDec(OnOffBTN_encodeBcdField(val, ONOFFBTN_RTC_MAX_HOURS)) == (val > 23 ? 23 : val)
+    && OnOffBTN_bcdToDec(OnOffBTN_encodeBcdField(val, ONOFFBTN_RTC_MAX_DAY_OF_MONTH)) == (val > 31 ? 31 : val)
+    && OnOffBTN_bcdToDec(OnOffBTN_encodeBcdField(val, ONOFFBTN_RTC_MAX_MONTH)) == (val > 12 ? 12 : val)
+    && OnOffBTN_bcdToDec(OnOffBTN_encodeBcdField(val, ONOFFBTN_RTC_MAX_YEAR)) == (val > 99 ? 99 : val);
+}
+
+static_assert(forAll<bcdFromDecimal>(0, 256), "OnOffBTN_decToBcd/bcdToDec: decimal round-trip");
+static_assert(forAll<bcdFromRegister>(0, 256), "OnOffBTN_decToBcd/bcdToDec: BCD round-trip");
+static_assert(forAll<bcdField>(0, 256), "OnOffBTN_encodeBcdField: field ranges");
+
+/////////////////////////////////////////////////////////
+// configuration registers
+
+constexpr bool hardResetBehavior(uint8_t raw)
+{
+  return OnOffBTN_encodeHardResetBehavior(OnOffBTN_decodeHardResetBehavior(raw)) == raw;
+}
+
+constexpr bool powerBehavior(uint8_t raw)
+{
+  return OnOffBTN_encodePowerBehavior(OnOffBTN_decodePowerBehavior(raw)) == (raw & 15);
+}
+
+constexpr bool framebufferRestore(uint8_t raw)
+{
+  return OnOffBTN_encodeFramebufferRestore(raw & 1, raw & 2) == (raw & 3);
+}
+
+static_assert(forAll<hardResetBehavior>(0, 256), "hard reset behavior register (0x04) round-trip");
+static_assert(forAll<powerBehavior>(0, 256), "power behavior register (0x05) round-trip");
+static_assert(forAll<framebufferRestore>(0, 4), "framebuffer restore bits (0x10) encoding");
+
+/////////////////////////////////////////////////////////
+// RTC registers
+
+constexpr bool rtcControl(uint8_t raw)
+{
+  return OnOffBTN_encodeRTCControl(OnOffBTN_decodeRTCControl(raw)) == (raw & 127);
+}
+
+constexpr bool alarmComponentFromRegister(uint8_t raw)
+{
+  // valid register contents (BCD up to 59) survive a decode/encode
+  return !isBcd(raw & 127) || OnOffBTN_bcdToDec(raw & 127) > 59 || OnOffBTN_encodeAlarmComponent(
+      OnOffBTN_decodeAlarmTime(raw, 0, 0).Seconds,
+      OnOffBTN_decodeAlarmTime(raw, 0, 0).MaskSeconds, ONOFFBTN_RTC_MAX_SECONDS) == raw;
+}
+
+constexpr bool alarmComponentFromValue(uint8_t val)
+{
+  return OnOffBTN_decodeAlarmTime(OnOffBTN_encodeAlarmComponent(val, false, ONOFFBTN_RTC_MAX_SECONDS), 0, 0).Seconds == (val > 59 ? 59 : val)
+    && OnOffBTN_decodeAlarmTime(0, 0, OnOffBTN_encodeAlarmComponent(val, false, ONOFFBTN_RTC_MAX_HOURS)).Hours == (val > 23 ? 23 : val)
+    && !OnOffBTN_decodeAlarmTime(OnOffBTN_encodeAlarmComponent(val, false, ONOFFBTN_RTC_MAX_SECONDS), 0, 0).MaskSeconds
+    && OnOffBTN_decodeAlarmTime(0, 0, OnOffBTN_encodeAlarmComponent(val, true, ONOFFBTN_RTC_MAX_HOURS)).MaskHours;
+}
+
+constexpr bool alarmDayDateFromRegister(uint8_t raw)
+{
+  return (raw & 64)
+    ? OnOffBTN_encodeAlarmDayDate(OnOffBTN_decodeAlarmDayDate(raw)) == (raw & 0xc7)
+    : !isBcd(raw & 63) || OnOffBTN_bcdToDec(raw & 63) > 31
+        || OnOffBTN_encodeAlarmDayDate(OnOffBTN_decodeAlarmDayDate(raw)) == raw;
+}
+
+constexpr bool alarmDayDateFromValue(uint8_t val)
+{
+  // the date never sets the weekday flag (bit 6) or the mask (bit 7)
+  return (OnOffBTN_encodeAlarmDayDate(OnOffBTN_AlarmDayDate { (uint8_t)(val & 63), false, false }) & 0xc0) == 0
+    && OnOffBTN_decodeAlarmDayDate(OnOffBTN_encodeAlarmDayDate(OnOffBTN_AlarmDayDate { (uint8_t)(val & 63), false, false })).Value
+        == ((val & 63) > 31 ? 31 : (val & 63))
+    && OnOffBTN_decodeAlarmDayDate(OnOffBTN_encodeAlarmDayDate(OnOffBTN_AlarmDayDate { (uint8_t)(val & 63), true, true })).Value
+        == (val & 7);
+}
+
+static_assert(forAll<rtcControl>(0, 256), "RTC control register (0xb0) round-trip");
+static_assert(forAll<alarmComponentFromRegister>(0, 256), "alarm time registers (0xb8-0xba) round-trip");
+static_assert(forAll<alarmComponentFromValue>(0, 256), "alarm time component encoding");
+static_assert(forAll<alarmDayDateFromRegister>(0, 256), "alarm day/date register (0xbb) round-trip");
+static_assert(forAll<alarmDayDateFromValue>(0, 64), "alarm day/date encoding");
+
+}
@@ -0,0 +1,62 @@
+/**
+    @file     hhtronik_onoffbtn_config.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Compile-time feature selection for the ÖnÖffBTN driver.
+
+    Every feature unit can be left out of the build by setting its switch to 0,
+    either here or with a compiler flag, e.g. -DONOFFBTN_ENABLE_RTC=0
+    (arduino-cli: --build-property "compiler.cpp.extra_flags=-DONOFFBTN_ENABLE_RTC=0",
+    PlatformIO: build_flags). The status, latch/reset and power configuration
+    core is always built.
+
+    Only set the switches in this file or with a global compiler flag, never
+    with a #define in your sketch before including hhtronik_onoffbtn.h: the
+    library's own source files wouldn't see it. The HHTronik_OnOffBTN class
+    layout depends on ONOFFBTN_ENABLE_FRAMEBUFFER (the framebuffer copy), so
+    the sketch and the library would disagree on the size of the object and
+    corrupt memory without any compiler or linker error.
+
+    The linker already drops functions you don't call on most cores, so the
+    main gain is RAM (the framebuffer copy is 27 bytes) and a guaranteed
+    minimal image. Run extras/footprint.sh to see the cost of each unit.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_CONFIG_H_
+#define _HHTRONIK_ONOFFBTN_CONFIG_H_
+
+// LED ring framebuffer access and the driver's framebuffer copy
+// (also required by the dithering, timeline, group and scheduler helpers)
+#ifndef ONOFFBTN_ENABLE_FRAMEBUFFER
+ #define ONOFFBTN_ENABLE_FRAMEBUFFER        (1)
+#endif
+
+// animation selection/configuration and stored framebuffers
+#ifndef ONOFFBTN_ENABLE_ANIMATION
+ #define ONOFFBTN_ENABLE_ANIMATION          (1)
+#endif
+
+// RTC, alarms (also required by the watchdog and the RTC part of
+// configuration profiles)
+#ifndef ONOFFBTN_ENABLE_RTC
+ #define ONOFFBTN_ENABLE_RTC                (1)
+#endif
+
+// User-EEPROM access (also required by the record store)
+#ifndef ONOFFBTN_ENABLE_USER_EEPROM
+ #define ONOFFBTN_ENABLE_USER_EEPROM        (1)
+#endif
+
+// thread-safe bus owner, Linux hosts only (needs std::thread and std::future)
+#ifndef ONOFFBTN_ENABLE_BUS_OWNER
+ #if defined(__linux__)
+  #define ONOFFBTN_ENABLE_BUS_OWNER         (1)
+ #else
+  #define ONOFFBTN_ENABLE_BUS_OWNER         (0)
+ #endif
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+/**
+    @file     hhtronik_onoffbtn_dispatch.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Compile-time event dispatch for the HHTronik ÖnÖffBTN status register.
+
+    Handlers are bound as template arguments, so dispatching is a single pass
+    over the bits of the raw status byte with direct (inlinable) calls: no
+    function pointer table in RAM, no heap, no virtual calls. Events without
+    a handler compile to nothing.
+
+    Usage:
+
+      void onShortPress(uint8_t status) { ... }
+      void onAlarm(uint8_t status) { ... }
+
+      HHTronik_OnOffBTN_Dispatcher<
+        OnOffBTN_IgnoreEvent,   // Down
+        onShortPress,           // ShortPress
+        OnOffBTN_IgnoreEvent,   // LongPress
+        OnOffBTN_IgnoreEvent,   // DoubleClick
+        OnOffBTN_IgnoreEvent,   // PowerOn edge
+        onAlarm                 // RTC_Alarm
+      > dispatcher;
+
+      // in loop(), after an interrupt:
+      dispatcher.dispatch(btn);
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_DISPATCH_H_
+#define _HHTRONIK_ONOFFBTN_DISPATCH_H_
+
+#include "hhtronik_onoffbtn.h"
+
+/**
+ * Event handler signature, the argument is the raw status byte
+ * (see the ONOFFBTN_STATUS_* bit masks)
+ */
+typedef void (*OnOffBTN_EventHandler)(uint8_t status);
+
+/**
+ * Placeholder for events you don't want to handle
+ */
+inline void OnOffBTN_IgnoreEvent(uint8_t status) { (void)status; }
+
+template<
+  OnOffBTN_EventHandler OnDown          = OnOffBTN_IgnoreEvent,
+  OnOffBTN_EventHandler OnShortPress    = OnOffBTN_IgnoreEvent,
+  OnOffBTN_EventHandler OnLongPress     = OnOffBTN_IgnoreEvent,
+  OnOffBTN_EventHandler OnDoubleClick   = OnOffBTN_IgnoreEvent,
+  OnOffBTN_EventHandler OnPowerChanged  = OnOffBTN_IgnoreEvent,
+  OnOffBTN_EventHandler OnRTCAlarm      = OnOffBTN_IgnoreEvent
+>
+class HHTronik_OnOffBTN_Dispatcher {
+ public:
+  HHTronik_OnOffBTN_Dispatcher() : _lastStatus(0) {}
+
+  /**
+   * Call the handlers for every event flagged in the raw status byte.
+   * OnPowerChanged is called when the PowerOn bit differs from the previous
+   * dispatch (the first dispatch compares against "off").
+   *
+   * @param status the raw status byte, see HHTronik_OnOffBTN::getRawButtonStatus()
+   */
+  void dispatch(uint8_t status)
+  {
+    // PowerOn is a state, not an event: turn it into an edge
+    uint8_t pending = (status & ~ONOFFBTN_STATUS_POWERON)
+                    | ((status ^ _lastStatus) & ONOFFBTN_STATUS_POWERON);
+    _lastStatus = status;
+
+    _call<OnDown>         (pending, ONOFFBTN_STATUS_DOWN,        status);
+    _call<OnShortPress>   (pending, ONOFFBTN_STATUS_SHORTPRESS,  status);
+    _call<OnLongPress>    (pending, ONOFFBTN_STATUS_LONGPRESS,   status);
+    _call<OnDoubleClick>  (pending, ONOFFBTN_STATUS_DOUBLECLICK, status);
+    _call<OnPowerChanged> (pending, ONOFFBTN_STATUS_POWERON,     status);
+    _call<OnRTCAlarm>     (pending, ONOFFBTN_STATUS_RTCALARM,    status);
+  }
+
+  /**
+   * Read the status register and dispatch it
+   * @returns the raw status byte
+   */
+  uint8_t dispatch(HHTronik_OnOffBTN &btn)
+  {
+    uint8_t status = btn.getRawButtonStatus();
+    dispatch(status);
+    return status;
+  }
+
+ private:
+  uint8_t _lastStatus;
+
+  template<OnOffBTN_EventHandler Handler>
+  static inline void _call(uint8_t pending, uint8_t mask, uint8_t status)
+  {
+    // resolved at compile time for unbound events
+    if(Handler == OnOffBTN_IgnoreEvent) return;
+
+    if(pending & mask) Handler(status);
+  }
+};
+
+#endif
@@ -0,0 +1,68 @@
+/**
+    @file     hhtronik_onoffbtn_dither.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Temporal dithering for the ÖnÖffBTN LED ring.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_dither.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_Dither::HHTronik_OnOffBTN_Dither()
+{
+    memset(_framebuffer, 0, sizeof(_framebuffer));
+    reset();
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void
+HHTronik_OnOffBTN_Dither::setPixel(uint8_t pixel, uint16_t r, uint16_t g, uint16_t b)
+{
+    // avoid writing over the boundaries
+    if(pixel >= ONOFFBTN_NUM_PIXELS) return;
+
+    _framebuffer[pixel * 3 + 0] = r;
+    _framebuffer[pixel * 3 + 1] = g;
+    _framebuffer[pixel * 3 + 2] = b;
+}
+
+void
+HHTronik_OnOffBTN_Dither::render(uint8_t *frame)
+{
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+    {
+        uint16_t value = _framebuffer[i];
+
+        // add the low byte to what we owe this subpixel from previous frames
+        uint16_t accumulator = (uint16_t)_error[i] + (value & 0xff);
+        uint16_t output = (value >> 8) + (accumulator >> 8);
+
+        _error[i] = accumulator & 0xff;
+        frame[i] = (output > 255) ? 255 : output;
+    }
+}
+
+uint8_t
+HHTronik_OnOffBTN_Dither::show(HHTronik_OnOffBTN &btn)
+{
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+    render(frame);
+    return btn.updateFramebuffer(frame);
+}
+
+void
+HHTronik_OnOffBTN_Dither::reset( void )
+{
+    memset(_error, 0, sizeof(_error));
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+    @file     hhtronik_onoffbtn_dither.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Temporal dithering for the ÖnÖffBTN LED ring.
+
+    At low intensities the 8 bit steps of the LEDs are clearly visible. This
+    stage keeps a 16 bit per subpixel framebuffer on the host and emits 8 bit
+    frames where the dropped low byte is carried over from frame to frame
+    (error accumulation), so that on average the LEDs show the 16 bit value.
+    Frames are sent with HHTronik_OnOffBTN::updateFramebuffer(), so only the
+    subpixels that toggle are transferred.
+
+    The faster you call show(), the less flicker: see the ditheredBreath example
+    for CPU and bus cost measurements.
+
+    RAM: 81 bytes (54 for the 16 bit framebuffer, 27 for the error accumulators)
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_DITHER_H_
+#define _HHTRONIK_ONOFFBTN_DITHER_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+class HHTronik_OnOffBTN_Dither {
+ public:
+  HHTronik_OnOffBTN_Dither();
+
+  /**
+    Set a single pixel of the 16 bit framebuffer
+
+    @param pixel zero-based pixel index
+    @param r Red color component (0 - 65535)
+    @param g Green color component (0 - 65535)
+    @param b Blue color component (0 - 65535)
+  */
+  void setPixel(uint8_t pixel, uint16_t r, uint16_t g, uint16_t b);
+
+  /**
+    Direct access to the ONOFFBTN_FRAMEBUFFER_SIZE subpixels of the 16 bit framebuffer
+  */
+  uint16_t *getFramebuffer( void ) { return _framebuffer; }
+
+  /**
+    Compute the next 8 bit frame
+
+    @param frame destination buffer of ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+  */
+  void render(uint8_t *frame);
+
+  /**
+    Compute the next 8 bit frame and send it to the ÖnÖffBTN
+
+    @returns the number of subpixels sent
+  */
+  uint8_t show(HHTronik_OnOffBTN &btn);
+
+  /**
+    Reset the error accumulators
+  */
+  void reset( void );
+
+ private:
+  uint16_t _framebuffer[ONOFFBTN_FRAMEBUFFER_SIZE];
+  uint8_t _error[ONOFFBTN_FRAMEBUFFER_SIZE];
+};
+
+#endif // ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#endif
@@ -0,0 +1,60 @@
+/**
+    @file     hhtronik_onoffbtn_eeprom.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Arduino driver for the HHTronik ÖnÖffBTN: User-EEPROM.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_USER_EEPROM
+
+/////////////////////////////////////////////////////////
+// Public:
+
+uint8_t 
+HHTronik_OnOffBTN::getUserEEPROMByte(uint8_t byteIndex)
+{
+    if(byteIndex > 15) return 255;  // we have 16 bytes of storage for the user
+    
+    return _i2c_readByte(0x30 + byteIndex);
+}
+
+void 
+HHTronik_OnOffBTN::setUserEEPROMByte(uint8_t byteIndex, uint8_t value)
+{
+    if(byteIndex > 15) return;  // we have 16 bytes of storage for the user
+    
+    _i2c_writeByte(0x30 + byteIndex, value);
+}
+
+uint8_t 
+HHTronik_OnOffBTN::readUserEEPROM(uint8_t offset, uint8_t *buffer, uint8_t length)
+{
+    if(offset >= ONOFFBTN_USER_EEPROM_SIZE || length == 0) return 0;
+    if(length > ONOFFBTN_USER_EEPROM_SIZE - offset) length = ONOFFBTN_USER_EEPROM_SIZE - offset;
+
+    return _i2c_readBytes(0x30 + offset, buffer, length);
+}
+
+uint8_t 
+HHTronik_OnOffBTN::writeUserEEPROM(uint8_t offset, const uint8_t *buffer, uint8_t length)
+{
+    uint8_t current[ONOFFBTN_USER_EEPROM_SIZE];
+
+    if(offset >= ONOFFBTN_USER_EEPROM_SIZE || length == 0) return 0;
+    if(length > ONOFFBTN_USER_EEPROM_SIZE - offset) length = ONOFFBTN_USER_EEPROM_SIZE - offset;
+
+    // if the read fails we can't compare, write everything
+    if(readUserEEPROM(offset, current, length) != length)
+    {
+        _i2c_writeBytes(0x30 + offset, buffer, length);
+        return length;
+    }
+
+    return _i2c_writeChanged(0x30 + offset, current, buffer, length);
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+    @file     hhtronik_onoffbtn_framebuffer.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Arduino driver for the HHTronik ÖnÖffBTN: framebuffer access.
+
+    Visit https://hhtronik.com for more information
+*/
+#include <Wire.h>
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void 
+HHTronik_OnOffBTN::clearFramebuffer( void )
+{
+    Wire.beginTransmission(i2c_addr);   // send address
+    Wire.write(0xd0);                   // select first byte of framebuffer
+
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+    {
+        Wire.write(0);
+    }
+
+    _i2c_result(!Wire.endTransmission());
+
+    memset(_framebuffer, 0, ONOFFBTN_FRAMEBUFFER_SIZE);
+    _framebufferValid = _lastTransferOk;
+}
+
+void 
+HHTronik_OnOffBTN::setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
+{   
+    // avoid writing over the boundaries 
+    if(pixel >= ONOFFBTN_NUM_PIXELS) return;
+
+    Wire.beginTransmission(i2c_addr);       // send address
+    Wire.write(0xd0 + pixel * 3);           // select first byte of selected pixel
+    Wire.write(r); 
+    Wire.write(g); 
+    Wire.write(b); 
+    _i2c_result(!Wire.endTransmission());  
+
+    _framebuffer[pixel * 3 + 0] = r;
+    _framebuffer[pixel * 3 + 1] = g;
+    _framebuffer[pixel * 3 + 2] = b;
+
+    // the device may hold anything now, don't trust the copy
+    if(!_lastTransferOk) _framebufferValid = false;
+}
+
+void 
+HHTronik_OnOffBTN::setPixels(const uint8_t *subpixel, const uint8_t length, const uint8_t offset)
+{
+    if(offset >= ONOFFBTN_FRAMEBUFFER_SIZE) return;
+    
+    Wire.beginTransmission(i2c_addr);       // send address
+    Wire.write(0xd0 + offset);              // select first byte of selected subpixel
+
+    for(uint8_t idx = offset; idx < length + offset; idx++)
+    {
+        if(idx >= ONOFFBTN_FRAMEBUFFER_SIZE) break;
+        _framebuffer[idx] = *subpixel;
+        Wire.write(*subpixel++);
+    }
+
+    _i2c_result(!Wire.endTransmission());
+
+    if(!_lastTransferOk) _framebufferValid = false;
+}
+
+uint8_t 
+HHTronik_OnOffBTN::updateFramebuffer(const uint8_t *frame)
+{
+    // resync our copy, or send everything if that fails
+    if(!_framebufferValid && !readFramebuffer())
+    {
+        setPixels(frame, ONOFFBTN_FRAMEBUFFER_SIZE);
+        _framebufferValid = _lastTransferOk;
+        return ONOFFBTN_FRAMEBUFFER_SIZE;
+    }
+
+    // a new transfer costs ~2 bytes (address + register), so we
+    // rather resend up to 2 unchanged subpixels in between
+    uint8_t sent = _i2c_writeChanged(0xd0, _framebuffer, frame, ONOFFBTN_FRAMEBUFFER_SIZE, 2);
+    memcpy(_framebuffer, frame, ONOFFBTN_FRAMEBUFFER_SIZE);
+
+    // a NACKed burst may have been dropped or cut short: read the framebuffer
+    // back next time instead of diffing against a copy that's wrong
+    if(!_lastTransferOk) _framebufferValid = false;
+
+    return sent;
+}
+
+bool 
+HHTronik_OnOffBTN::readFramebuffer(uint8_t *frame)
+{
+    _framebufferValid = _i2c_readBytes(0xd0, _framebuffer, ONOFFBTN_FRAMEBUFFER_SIZE) == ONOFFBTN_FRAMEBUFFER_SIZE;
+
+    if(frame != NULL)
+        memcpy(frame, _framebuffer, ONOFFBTN_FRAMEBUFFER_SIZE);
+
+    return _framebufferValid;
+}
+
+const uint8_t *
+HHTronik_OnOffBTN::getFramebuffer( void )
+{
+    if(!_framebufferValid)
+        readFramebuffer();
+
+    return _framebuffer;
+}
+
+#endif
@@ -0,0 +1,231 @@
+/**
+    @file     hhtronik_onoffbtn_gestures.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Host-side gesture recognition for the HHTronik ÖnÖffBTN.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_gestures.h"
+
+/////////////////////////////////////////////////////////
+// State machine:
+
+// states
+#define GST_IDLE        (0)     // waiting for the first press
+#define GST_PRESSED     (1)     // button is down
+#define GST_RELEASED    (2)     // button is up, waiting for the next press or the timeout
+#define GST_HELD        (3)     // the longest hold was reported, waiting for the release
+
+// events
+#define GEV_PRESS       (0)
+#define GEV_RELEASE     (1)
+#define GEV_TIMEOUT     (2)
+#define GEV_HOLD        (3)     // the longest hold threshold passed while down
+
+// actions (upper nibble of a transition)
+#define GAC_NONE        (0 << 4)
+#define GAC_FIRST       (1 << 4)    // first press of a gesture
+#define GAC_NEXT        (2 << 4)    // one more press
+#define GAC_RELEASE     (3 << 4)    // evaluate the hold time of the last press
+#define GAC_TIMEOUT     (4 << 4)    // the click sequence is over
+#define GAC_HOLD        (5 << 4)    // report the longest hold without waiting for the release
+
+// next state (lower nibble) | action (upper nibble), indexed by [state][event]
+static const uint8_t transitions[4][4] =
+{
+    //  GEV_PRESS                   GEV_RELEASE                     GEV_TIMEOUT                     GEV_HOLD
+    {   GST_PRESSED  | GAC_FIRST,   GST_IDLE     | GAC_NONE,        GST_IDLE     | GAC_NONE,        GST_IDLE     | GAC_NONE },  // GST_IDLE
+    {   GST_PRESSED  | GAC_NONE,    GST_RELEASED | GAC_RELEASE,     GST_PRESSED  | GAC_NONE,        GST_HELD     | GAC_HOLD },  // GST_PRESSED
+    {   GST_PRESSED  | GAC_NEXT,    GST_RELEASED | GAC_NONE,        GST_IDLE     | GAC_TIMEOUT,     GST_RELEASED | GAC_NONE },  // GST_RELEASED
+    {   GST_HELD     | GAC_NONE,    GST_IDLE     | GAC_NONE,        GST_HELD     | GAC_NONE,        GST_HELD     | GAC_NONE }   // GST_HELD
+};
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_GestureRecognizer::HHTronik_OnOffBTN_GestureRecognizer(const OnOffBTN_Gesture *gestures, uint8_t count, uint16_t clickTimeout)
+{
+    if(count > ONOFFBTN_GESTURE_MAX_COUNT) count = ONOFFBTN_GESTURE_MAX_COUNT;
+
+    _gestures = gestures;
+    _count = count;
+    _clickTimeout = clickTimeout;
+    reset();
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+int8_t
+HHTronik_OnOffBTN_GestureRecognizer::_findGesture(uint8_t presses, uint16_t heldFor)
+{
+    int8_t found = ONOFFBTN_NO_GESTURE;
+    uint16_t foundHoldTime = 0;
+
+    for(uint8_t i = 0; i < _count; i++)
+    {
+        if(_gestures[i].Presses != presses) continue;
+
+        uint16_t holdTime = _gestures[i].HoldTime;
+
+        // clicks only match clicks
+        if(heldFor == 0)
+        {
+            if(holdTime == 0) return i;
+            continue;
+        }
+
+        // holds match the longest threshold reached
+        if(holdTime > 0 && holdTime <= heldFor && holdTime >= foundHoldTime)
+        {
+            found = i;
+            foundHoldTime = holdTime;
+        }
+    }
+
+    return found;
+}
+
+uint16_t
+HHTronik_OnOffBTN_GestureRecognizer::_longestHold(uint8_t presses)
+{
+    uint16_t longest = 0;
+
+    for(uint8_t i = 0; i < _count; i++)
+    {
+        if(_gestures[i].Presses == presses && _gestures[i].HoldTime > longest)
+            longest = _gestures[i].HoldTime;
+    }
+
+    return longest;
+}
+
+bool
+HHTronik_OnOffBTN_GestureRecognizer::_hasLongerSequence(uint8_t presses)
+{
+    for(uint8_t i = 0; i < _count; i++)
+    {
+        if(_gestures[i].Presses > presses) return true;
+    }
+
+    return false;
+}
+
+int8_t
+HHTronik_OnOffBTN_GestureRecognizer::_handle(uint8_t event, uint32_t timestamp)
+{
+    uint8_t transition = transitions[_state][event];
+    int8_t result = ONOFFBTN_NO_GESTURE;
+
+    _state = transition & 0x0f;
+
+    switch(transition & 0xf0)
+    {
+    case GAC_FIRST:
+        _presses = 1;
+        _edgeTime = timestamp;
+        break;
+
+    case GAC_NEXT:
+        if(_presses < 255) _presses++;
+        _edgeTime = timestamp;
+        break;
+
+    case GAC_RELEASE:
+    {
+        uint32_t heldFor = timestamp - _edgeTime;
+        if(heldFor > 0xffff) heldFor = 0xffff;
+
+        // a press held past one of the thresholds ends the gesture. A press
+        // and release seen in the same read (heldFor = 0) is always a click.
+        if(heldFor > 0)
+        {
+            result = _findGesture(_presses, (uint16_t)heldFor);
+            if(result != ONOFFBTN_NO_GESTURE)
+            {
+                _state = GST_IDLE;
+                break;
+            }
+        }
+
+        // otherwise it's a click: if no gesture needs more presses there's
+        // no point in waiting for the timeout
+        if(!_hasLongerSequence(_presses))
+        {
+            result = _findGesture(_presses, 0);
+            _state = GST_IDLE;
+            break;
+        }
+
+        _edgeTime = timestamp;
+        break;
+    }
+
+    case GAC_TIMEOUT:
+        result = _findGesture(_presses, 0);
+        break;
+
+    case GAC_HOLD:
+        result = _findGesture(_presses, _longestHold(_presses));
+        break;
+
+    default:
+        break;
+    }
+
+    return result;
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+int8_t
+HHTronik_OnOffBTN_GestureRecognizer::feed(OnOffBTN_StatusRegister status, uint32_t timestamp)
+{
+    // a pending click sequence may have timed out before this edge
+    int8_t result = update(timestamp);
+
+    // the press edge comes first: a quick click can report "down" and
+    // "short press" within the same read
+    if(status.Down)
+    {
+        int8_t gesture = _handle(GEV_PRESS, timestamp);
+        if(gesture != ONOFFBTN_NO_GESTURE) result = gesture;
+    }
+
+    if(status.ShortPress || status.LongPress)
+    {
+        int8_t gesture = _handle(GEV_RELEASE, timestamp);
+        if(gesture != ONOFFBTN_NO_GESTURE) result = gesture;
+    }
+
+    return result;
+}
+
+int8_t
+HHTronik_OnOffBTN_GestureRecognizer::update(uint32_t now)
+{
+    // no longer hold to wait for: report it while the button is still down
+    if(_state == GST_PRESSED)
+    {
+        uint16_t longest = _longestHold(_presses);
+        if(longest == 0 || now - _edgeTime < longest) return ONOFFBTN_NO_GESTURE;
+
+        return _handle(GEV_HOLD, now);
+    }
+
+    if(_state != GST_RELEASED) return ONOFFBTN_NO_GESTURE;
+    if(now - _edgeTime < _clickTimeout) return ONOFFBTN_NO_GESTURE;
+
+    return _handle(GEV_TIMEOUT, now);
+}
+
+void
+HHTronik_OnOffBTN_GestureRecognizer::reset( void )
+{
+    _state = GST_IDLE;
+    _presses = 0;
+    _edgeTime = 0;
+}
@@ -0,0 +1,109 @@
+/**
+    @file     hhtronik_onoffbtn_gestures.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Host-side gesture recognition for the HHTronik ÖnÖffBTN.
+
+    The ÖnÖffBTN only reports "short press", "long press" and "double click".
+    The recognizer below builds a richer vocabulary (triple clicks, holds at
+    several thresholds, click-then-hold, ...) out of the press/release edges
+    contained in the status register you already read on every interrupt.
+    It never touches the I2C bus itself.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_GESTURES_H_
+#define _HHTRONIK_ONOFFBTN_GESTURES_H_
+
+#include "hhtronik_onoffbtn.h"
+
+// max. time (in ms) between a release and the next press for both to
+// belong to the same gesture
+#define ONOFFBTN_GESTURE_CLICK_TIMEOUT      (400)
+
+// returned by the recognizer when no gesture has completed
+#define ONOFFBTN_NO_GESTURE                 (-1)
+
+// gesture indices are returned as int8_t, entries past this are ignored
+#define ONOFFBTN_GESTURE_MAX_COUNT          (127)
+
+/**
+ * A gesture is a number of presses where the last one is either a click
+ * (HoldTime = 0) or held down for at least HoldTime milliseconds.
+ *
+ * Holds are recognized on release, except the longest hold for a number of
+ * presses: it is reported by update() as soon as its threshold passes, while
+ * the button is still down (the release is ignored then).
+ *
+ * Examples:
+ * { 3, 0 }      triple click
+ * { 1, 5000 }   hold for 5 seconds
+ * { 2, 1000 }   click, then press and hold for 1 second
+ */
+typedef struct
+{
+  uint8_t Presses;
+  uint16_t HoldTime;
+} OnOffBTN_Gesture;
+
+class HHTronik_OnOffBTN_GestureRecognizer {
+ public:
+  /**
+   * Create a recognizer for a table of gestures. The table is not copied,
+   * so it must outlive the recognizer (a global const array is fine).
+   *
+   * @param gestures pointer to the gesture table
+   * @param count number of entries in the gesture table (at most
+   * ONOFFBTN_GESTURE_MAX_COUNT)
+   * @param clickTimeout max. time (in ms) between a release and the next press
+   */
+  HHTronik_OnOffBTN_GestureRecognizer(const OnOffBTN_Gesture *gestures, uint8_t count,
+    uint16_t clickTimeout = ONOFFBTN_GESTURE_CLICK_TIMEOUT);
+
+  /**
+   * Feed a status register read to the recognizer.
+   *
+   * @param status the status as returned by HHTronik_OnOffBTN::getButtonStatus()
+   * @param timestamp time of the interrupt in ms (e.g. millis() captured in the ISR)
+   * @returns the index of the completed gesture in the table or ONOFFBTN_NO_GESTURE
+   */
+  int8_t feed(OnOffBTN_StatusRegister status, uint32_t timestamp);
+
+  /**
+   * Let the recognizer handle timeouts (multi-click sequences end when no further
+   * press happens within the click timeout, the longest hold ends once its
+   * threshold passes). Call this regularly from loop().
+   *
+   * @param now current time in ms (millis())
+   * @returns the index of the completed gesture in the table or ONOFFBTN_NO_GESTURE
+   */
+  int8_t update(uint32_t now);
+
+  /**
+   * Drop any gesture in progress
+   */
+  void reset( void );
+
+  /**
+   * Number of presses of the gesture currently in progress
+   */
+  uint8_t getPressCount( void ) { return _presses; }
+
+ private:
+  const OnOffBTN_Gesture *_gestures;
+  uint8_t _count;
+  uint16_t _clickTimeout;
+
+  uint8_t _state;
+  uint8_t _presses;
+  uint32_t _edgeTime;
+
+  int8_t _handle(uint8_t event, uint32_t timestamp);
+  int8_t _findGesture(uint8_t presses, uint16_t heldFor);
+  uint16_t _longestHold(uint8_t presses);
+  bool _hasLongerSequence(uint8_t presses);
+};
+
+#endif
@@ -0,0 +1,116 @@
+/**
+    @file     hhtronik_onoffbtn_group.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Synchronized frame updates for several ÖnÖffBTNs on the same bus.
+
+    Visit https://hhtronik.com for more information
+*/
+#include <Wire.h>
+#include "hhtronik_onoffbtn_group.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_Group::HHTronik_OnOffBTN_Group()
+{
+    _count = 0;
+    _repeatedStart = true;
+    _lastSkew = 0;
+    _maxSkew = 0;
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+bool
+HHTronik_OnOffBTN_Group::add(HHTronik_OnOffBTN &btn)
+{
+    if(_count >= ONOFFBTN_GROUP_MAX_DEVICES) return false;
+
+    _devices[_count++] = &btn;
+    return true;
+}
+
+uint8_t
+HHTronik_OnOffBTN_Group::commit(const uint8_t * const *frames)
+{
+    uint8_t spanStart[ONOFFBTN_GROUP_MAX_DEVICES];
+    uint8_t spanLength[ONOFFBTN_GROUP_MAX_DEVICES];
+    uint8_t result[ONOFFBTN_GROUP_MAX_DEVICES];
+    int8_t lastDevice = -1;
+    uint8_t sent = 0;
+    uint8_t changed = 0;
+
+    // 1. work out every payload: a single span per device from the first
+    //    to the last changed subpixel, so each device gets exactly one burst
+    for(uint8_t d = 0; d < _count; d++)
+    {
+        const uint8_t *current = _devices[d]->getFramebuffer();  // reads back if needed
+        const uint8_t *frame = frames[d];
+        uint8_t first = 0;
+        uint8_t last = ONOFFBTN_FRAMEBUFFER_SIZE;
+
+        // if the read back failed we can't diff, send everything
+        if(_devices[d]->_framebufferValid)
+        {
+            while(first < ONOFFBTN_FRAMEBUFFER_SIZE && current[first] == frame[first]) first++;
+            while(last > first && current[last - 1] == frame[last - 1]) last--;
+        }
+
+        spanStart[d] = first;
+        spanLength[d] = last - first;
+
+        if(spanLength[d] > 0) lastDevice = d;
+    }
+
+    if(lastDevice < 0) return 0;
+
+    // 2. emit the bursts back to back, nothing but the transfers
+    //    and a timestamp in this loop
+    uint32_t firstDone = 0;
+    uint32_t lastDone = 0;
+
+    for(uint8_t d = 0; d <= lastDevice; d++)
+    {
+        if(spanLength[d] == 0) continue;
+
+        Wire.beginTransmission(_devices[d]->i2c_addr);
+        Wire.write(0xd0 + spanStart[d]);
+        Wire.write(frames[d] + spanStart[d], spanLength[d]);
+        result[d] = Wire.endTransmission(!_repeatedStart || d == lastDevice);
+
+        lastDone = micros();
+        if(sent++ == 0) firstDone = lastDone;
+    }
+
+    // 3. bookkeeping
+    for(uint8_t d = 0; d <= lastDevice; d++)
+    {
+        if(spanLength[d] == 0) continue;
+
+        HHTronik_OnOffBTN *device = _devices[d];
+        device->_i2c_result(result[d] == 0);
+
+        // we don't know what arrived: have the next commit read it back
+        if(result[d] != 0)
+        {
+            device->_framebufferValid = false;
+            continue;
+        }
+
+        memcpy(device->_framebuffer + spanStart[d], frames[d] + spanStart[d], spanLength[d]);
+        device->_framebufferValid = true;
+        changed++;
+    }
+
+    _lastSkew = lastDone - firstDone;
+    if(_lastSkew > _maxSkew) _maxSkew = _lastSkew;
+
+    return changed;
+}
+
+#endif
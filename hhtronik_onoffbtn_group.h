@@ -0,0 +1,85 @@
+/**
+    @file     hhtronik_onoffbtn_group.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Synchronized frame updates for several ÖnÖffBTNs on the same bus.
+
+    Updating the LED rings one after the other with setPixels() interleaves
+    the transfers with the frame computations, so rings visibly tear against
+    each other and the skew grows with every device. A group commit first
+    works out every device's payload (reading back framebuffers that need it
+    and computing the changed spans), then emits all the transfers back to
+    back, chained with repeated starts so no other bus master can get in
+    between.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_GROUP_H_
+#define _HHTRONIK_ONOFFBTN_GROUP_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#define ONOFFBTN_GROUP_MAX_DEVICES          (8)
+
+class HHTronik_OnOffBTN_Group {
+ public:
+  HHTronik_OnOffBTN_Group();
+
+  /**
+   * Add a device to the group (call begin() on it first)
+   * @returns false when the group is full
+   */
+  bool add(HHTronik_OnOffBTN &btn);
+
+  /**
+   * Number of devices in the group
+   */
+  uint8_t getCount( void ) { return _count; }
+
+  /**
+   * Chain the transfers with repeated starts (default) instead of sending
+   * a STOP after each device. Turn this off if your Wire implementation
+   * doesn't support endTransmission(false) for writes.
+   */
+  void setRepeatedStart(bool enabled) { _repeatedStart = enabled; }
+
+  /**
+   * Send a new frame to every device of the group
+   *
+   * @param frames one pointer to ONOFFBTN_FRAMEBUFFER_SIZE subpixels per device,
+   * in the order the devices were added
+   * @returns the number of devices whose framebuffer changed. A device
+   * that didn't acknowledge its transfer isn't counted, it gets its frame
+   * on the next commit.
+   */
+  uint8_t commit(const uint8_t * const *frames);
+
+  /**
+   * Time (in us) between the end of the first and the end of the last
+   * transfer of the last commit
+   */
+  uint32_t getLastSkew( void ) { return _lastSkew; }
+
+  /**
+   * Largest skew (in us) seen since the last call to resetSkew()
+   */
+  uint32_t getMaxSkew( void ) { return _maxSkew; }
+
+  void resetSkew( void ) { _lastSkew = _maxSkew = 0; }
+
+ private:
+  HHTronik_OnOffBTN *_devices[ONOFFBTN_GROUP_MAX_DEVICES];
+  uint8_t _count;
+  bool _repeatedStart;
+
+  uint32_t _lastSkew;
+  uint32_t _maxSkew;
+};
+
+#endif // ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#endif
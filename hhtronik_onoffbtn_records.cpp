@@ -0,0 +1,139 @@
+/**
+    @file     hhtronik_onoffbtn_records.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Wear-leveled record store in the ÖnÖffBTN User-EEPROM.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_records.h"
+
+#if ONOFFBTN_ENABLE_USER_EEPROM
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_RecordStore::HHTronik_OnOffBTN_RecordStore(HHTronik_OnOffBTN &btn, uint8_t recordSize, uint8_t version)
+{
+    if(recordSize < 1) recordSize = 1;
+    if(recordSize > ONOFFBTN_RECORD_MAX_SIZE) recordSize = ONOFFBTN_RECORD_MAX_SIZE;
+
+    _btn = &btn;
+    _recordSize = recordSize;
+    _version = version;
+    _slots = ONOFFBTN_USER_EEPROM_SIZE / (recordSize + ONOFFBTN_RECORD_OVERHEAD);
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+bool
+HHTronik_OnOffBTN_RecordStore::_isValid(const uint8_t *slot)
+{
+    uint8_t length = _recordSize + 1;   // sequence + record
+    bool erased = (slot[length] == 0xff);
+
+    for(uint8_t i = 0; i < length && erased; i++)
+        erased = (slot[i] == 0xff);
+
+    // an erased slot could pass the CRC by chance
+    if(erased) return false;
+
+    return crc8(slot, length, _seed()) == slot[length];
+}
+
+int8_t
+HHTronik_OnOffBTN_RecordStore::_findNewest(const uint8_t *eeprom)
+{
+    uint8_t slotSize = _recordSize + ONOFFBTN_RECORD_OVERHEAD;
+    int8_t newest = -1;
+    uint8_t newestSequence = 0;
+
+    for(uint8_t slot = 0; slot < _slots; slot++)
+    {
+        const uint8_t *data = eeprom + slot * slotSize;
+        if(!_isValid(data)) continue;
+
+        // sequence numbers wrap around, compare them as serial numbers
+        if(newest < 0 || (int8_t)(data[0] - newestSequence) > 0)
+        {
+            newest = slot;
+            newestSequence = data[0];
+        }
+    }
+
+    return newest;
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+uint8_t
+HHTronik_OnOffBTN_RecordStore::crc8(const uint8_t *data, uint8_t length, uint8_t crc)
+{
+    while(length--)
+    {
+        crc ^= *data++;
+
+        for(uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+
+    return crc;
+}
+
+bool
+HHTronik_OnOffBTN_RecordStore::read(uint8_t *record)
+{
+    uint8_t eeprom[ONOFFBTN_USER_EEPROM_SIZE];
+
+    if(_btn->readUserEEPROM(0, eeprom, ONOFFBTN_USER_EEPROM_SIZE) != ONOFFBTN_USER_EEPROM_SIZE)
+        return false;
+
+    int8_t newest = _findNewest(eeprom);
+    if(newest < 0) return false;
+
+    memcpy(record, eeprom + newest * (_recordSize + ONOFFBTN_RECORD_OVERHEAD) + 1, _recordSize);
+    return true;
+}
+
+bool
+HHTronik_OnOffBTN_RecordStore::write(const uint8_t *record)
+{
+    uint8_t eeprom[ONOFFBTN_USER_EEPROM_SIZE];
+    uint8_t slotSize = _recordSize + ONOFFBTN_RECORD_OVERHEAD;
+    uint8_t sequence = 0;
+    uint8_t slot = 0;
+
+    if(_btn->readUserEEPROM(0, eeprom, ONOFFBTN_USER_EEPROM_SIZE) != ONOFFBTN_USER_EEPROM_SIZE)
+        return false;
+
+    int8_t newest = _findNewest(eeprom);
+    if(newest >= 0)
+    {
+        const uint8_t *current = eeprom + newest * slotSize;
+
+        // unchanged: spare the EEPROM
+        if(memcmp(current + 1, record, _recordSize) == 0) return true;
+
+        sequence = current[0] + 1;
+        slot = (newest + 1) % _slots;
+    }
+
+    // assemble the slot
+    uint8_t *data = eeprom + slot * slotSize;
+    data[0] = sequence;
+    memcpy(data + 1, record, _recordSize);
+    data[_recordSize + 1] = crc8(data, _recordSize + 1, _seed());
+
+    _btn->writeUserEEPROM(slot * slotSize, data, slotSize);
+
+    // verify
+    uint8_t check[ONOFFBTN_USER_EEPROM_SIZE];
+    if(_btn->readUserEEPROM(slot * slotSize, check, slotSize) != slotSize) return false;
+
+    return memcmp(check, data, slotSize) == 0;
+}
+
+#endif
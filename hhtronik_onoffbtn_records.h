@@ -0,0 +1,93 @@
+/**
+    @file     hhtronik_onoffbtn_records.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    A tiny wear-leveled record store on top of the ÖnÖffBTN's 16 bytes of
+    User-EEPROM (boot counters, last shutdown reason, ...).
+
+    The EEPROM is split in as many slots as fit:
+
+      [ sequence ][ record (recordSize bytes) ][ CRC-8 ]
+
+    Every write goes to the slot following the newest one, so the cells are
+    worn evenly, and a write interrupted by a power loss leaves the previous
+    record intact. That takes two slots at least: records of 7 bytes or more
+    only fit once, each write overwrites the only copy and an interrupted
+    write loses it.
+
+    The CRC is seeded with the complement of a layout version: records
+    written with another version (or never written at all, erased or zeroed
+    cells) read as "no record".
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_RECORDS_H_
+#define _HHTRONIK_ONOFFBTN_RECORDS_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_USER_EEPROM
+
+// sequence + CRC
+#define ONOFFBTN_RECORD_OVERHEAD            (2)
+#define ONOFFBTN_RECORD_MAX_SIZE            (ONOFFBTN_USER_EEPROM_SIZE - ONOFFBTN_RECORD_OVERHEAD)
+
+class HHTronik_OnOffBTN_RecordStore {
+ public:
+  /**
+   * @param btn the driver used to access the User-EEPROM
+   * @param recordSize size of a record in bytes (1 to ONOFFBTN_RECORD_MAX_SIZE).
+   * Smaller records mean more slots to rotate through: 2 bytes give 4 slots,
+   * 6 bytes give 2 slots, 7 bytes and more a single slot (no power loss
+   * protection).
+   * @param version layout version (0 to 254), change it when the record
+   * layout changes
+   */
+  HHTronik_OnOffBTN_RecordStore(HHTronik_OnOffBTN &btn, uint8_t recordSize, uint8_t version = 0);
+
+  /**
+   * Read the newest valid record
+   * @param record destination buffer of recordSize bytes
+   * @returns false if no valid record exists
+   */
+  bool read(uint8_t *record);
+
+  /**
+   * Store a record in the next slot. Nothing is written when the record
+   * equals the newest stored one.
+   * @param record recordSize bytes to store
+   * @returns false if the record could not be verified after writing
+   */
+  bool write(const uint8_t *record);
+
+  /**
+   * Number of slots the EEPROM is divided in
+   */
+  uint8_t getSlotCount( void ) { return _slots; }
+
+  /**
+   * Compute the CRC-8 (polynomial 0x07) of a buffer
+   */
+  static uint8_t crc8(const uint8_t *data, uint8_t length, uint8_t crc = 0);
+
+ private:
+  HHTronik_OnOffBTN *_btn;
+  uint8_t _recordSize;
+  uint8_t _version;
+  uint8_t _slots;
+
+  int8_t _findNewest(const uint8_t *eeprom);
+  bool _isValid(const uint8_t *slot);
+
+  /**
+   * CRC seed: never 0 (for versions up to 254), so zeroed cells, whose
+   * CRC-8 would be 0, don't pass as a record
+   */
+  uint8_t _seed( void ) { return _version ^ 0xff; }
+};
+
+#endif // ONOFFBTN_ENABLE_USER_EEPROM
+
+#endif
@@ -0,0 +1,103 @@
+/**
+    @file     hhtronik_onoffbtn_rtc.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+    
+    Arduino driver for the HHTronik ÖnÖffBTN: RTC and alarms.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_RTC
+
+/////////////////////////////////////////////////////////
+// Public:
+
+OnOffBTN_RTCControlRegister 
+HHTronik_OnOffBTN::getRTCConfiguration( void )
+{
+    return OnOffBTN_decodeRTCControl(_i2c_readByte(0xb0));  // RTC CONTROL register at 0xb0
+}
+
+void 
+HHTronik_OnOffBTN::setRTCConfiguration(OnOffBTN_RTCControlRegister configuration)
+{
+    _i2c_writeByte(0xb0, OnOffBTN_encodeRTCControl(configuration));
+}
+
+#define OOB_DATETIMELENGTH (7)
+
+OnOffBTN_DateTime 
+HHTronik_OnOffBTN::getDateTime( void )
+{
+    uint8_t bytesRcv[OOB_DATETIMELENGTH] = { 0 };
+
+    // read the 7 bytes starting at register 0xb1 (RTC seconds)
+    _i2c_readBytes(0xb1, bytesRcv, OOB_DATETIMELENGTH);
+
+    OnOffBTN_DateTime result;
+    result.Seconds = bcdToDec(bytesRcv[0]);
+    result.Minutes = bcdToDec(bytesRcv[1]);
+    result.Hours = bcdToDec(bytesRcv[2]);
+    result.DayOfMonth = bcdToDec(bytesRcv[3]);
+    result.Month = bcdToDec(bytesRcv[4]);
+    result.Year = bcdToDec(bytesRcv[5]);
+    result.DayOfWeek = bytesRcv[6];         // this one's not BCD coded!
+
+    return result;
+}
+
+void 
+HHTronik_OnOffBTN::setDateTime(OnOffBTN_DateTime datetime)
+{
+    uint8_t bytesSnd[OOB_DATETIMELENGTH];
+    bytesSnd[0] = OnOffBTN_encodeBcdField(datetime.Seconds,    ONOFFBTN_RTC_MAX_SECONDS);
+    bytesSnd[1] = OnOffBTN_encodeBcdField(datetime.Minutes,    ONOFFBTN_RTC_MAX_MINUTES);
+    bytesSnd[2] = OnOffBTN_encodeBcdField(datetime.Hours,      ONOFFBTN_RTC_MAX_HOURS);
+    bytesSnd[3] = OnOffBTN_encodeBcdField(datetime.DayOfMonth, ONOFFBTN_RTC_MAX_DAY_OF_MONTH);
+    bytesSnd[4] = OnOffBTN_encodeBcdField(datetime.Month,      ONOFFBTN_RTC_MAX_MONTH);
+    bytesSnd[5] = OnOffBTN_encodeBcdField(datetime.Year,       ONOFFBTN_RTC_MAX_YEAR);
+    bytesSnd[6] = datetime.DayOfWeek & 7;   // not bcd coded, 3 bits
+
+    _i2c_writeBytes(0xb1, bytesSnd, OOB_DATETIMELENGTH);   // starting at register 0xb1 (RTC seconds)
+}
+
+#define OOB_ALARMTIMELENGTH (3)
+#define OOB_ALARMDAYDATELENGTH (1)
+
+OnOffBTN_AlarmTime 
+HHTronik_OnOffBTN::getAlarmTime( void )
+{
+    uint8_t bytesRcv[OOB_ALARMTIMELENGTH] = { 0 };
+
+    // read the 3 bytes starting at register 0xb8 (RTC ALMAR1)
+    _i2c_readBytes(0xb8, bytesRcv, OOB_ALARMTIMELENGTH);
+
+    return OnOffBTN_decodeAlarmTime(bytesRcv[0], bytesRcv[1], bytesRcv[2]);
+}
+
+void
+HHTronik_OnOffBTN::setAlarmTime(OnOffBTN_AlarmTime alarmTime)
+{
+    uint8_t bytesSnd[OOB_ALARMTIMELENGTH];
+    bytesSnd[0] = OnOffBTN_encodeAlarmComponent(alarmTime.Seconds, alarmTime.MaskSeconds, ONOFFBTN_RTC_MAX_SECONDS);
+    bytesSnd[1] = OnOffBTN_encodeAlarmComponent(alarmTime.Minutes, alarmTime.MaskMinutes, ONOFFBTN_RTC_MAX_MINUTES);
+    bytesSnd[2] = OnOffBTN_encodeAlarmComponent(alarmTime.Hours,   alarmTime.MaskHours,   ONOFFBTN_RTC_MAX_HOURS);
+
+    _i2c_writeBytes(0xb8, bytesSnd, OOB_ALARMTIMELENGTH);  // starting at register 0xb8 (RTC ALMAR1)
+}
+
+OnOffBTN_AlarmDayDate 
+HHTronik_OnOffBTN::getAlarmDayDate( void )
+{
+    return OnOffBTN_decodeAlarmDayDate(_i2c_readByte(0xbb));
+}
+
+void 
+HHTronik_OnOffBTN::setAlarmDayDate(OnOffBTN_AlarmDayDate  value)
+{
+    _i2c_writeByte(0xbb, OnOffBTN_encodeAlarmDayDate(value));
+}
+
+#endif
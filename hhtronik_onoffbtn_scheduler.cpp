@@ -0,0 +1,212 @@
+/**
+    @file     hhtronik_onoffbtn_scheduler.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Prioritized bus traffic for the ÖnÖffBTN.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_scheduler.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+// status bits that report events, the others are states
+#define STATUS_EVENTS (ONOFFBTN_STATUS_SHORTPRESS | ONOFFBTN_STATUS_LONGPRESS | ONOFFBTN_STATUS_DOUBLECLICK | ONOFFBTN_STATUS_RTCALARM)
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_Scheduler::HHTronik_OnOffBTN_Scheduler(HHTronik_OnOffBTN &btn, uint8_t chunkPixels)
+{
+    if(chunkPixels < 1) chunkPixels = 1;
+    if(chunkPixels > ONOFFBTN_NUM_PIXELS) chunkPixels = ONOFFBTN_NUM_PIXELS;
+
+    _btn = &btn;
+    _chunkSize = chunkPixels * 3;
+
+    _statusRequested = false;
+    _requestTime = 0;
+    _hasStatus = false;
+    _status = 0;
+    _lastLatency = 0;
+    _worstLatency = 0;
+
+    _command = 0;
+
+    _queueHead = 0;
+    _queueCount = 0;
+
+    _pendingSubpixels = 0;
+    _resend = false;
+    _nextSubpixel = 0;
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+void
+HHTronik_OnOffBTN_Scheduler::_serveUrgent( void )
+{
+    if(_statusRequested)
+    {
+        // _requestTime is written by the ISR
+        noInterrupts();
+        uint32_t requested = _requestTime;
+        _statusRequested = false;
+        interrupts();
+
+        uint8_t lastStatus = _btn->_lastStatus;
+        uint8_t raw = _btn->getRawButtonStatus();
+
+        _lastLatency = micros() - requested;
+        if(_lastLatency > _worstLatency) _worstLatency = _lastLatency;
+
+        _status = ((_status | raw) & STATUS_EVENTS) | (raw & ~STATUS_EVENTS);
+        _hasStatus = true;
+
+        // the device replaced its framebuffer, a resend in progress has to
+        // start over
+        if((raw ^ lastStatus) & ONOFFBTN_STATUS_POWERON)
+            _resend = false;
+    }
+
+    if(_command)
+    {
+        _btn->_i2c_writeByte(0x01, _command);
+        _command = 0;
+    }
+}
+
+uint8_t
+HHTronik_OnOffBTN_Scheduler::_sendChunk( void )
+{
+    // the device replaced its framebuffer (power state change) or a chunk
+    // failed: our copy is useless, resend the whole frame. The copy is only
+    // trusted again once every chunk of the resend went through.
+    if(!_btn->_framebufferValid && !_resend)
+    {
+        _resend = true;
+        _pendingSubpixels = ONOFFBTN_FRAMEBUFFER_SIZE;
+    }
+
+    uint8_t start = _nextSubpixel;
+    uint8_t length = ONOFFBTN_FRAMEBUFFER_SIZE - start;
+    if(length > _chunkSize) length = _chunkSize;
+
+    uint8_t sent = length;
+
+    if(_resend)
+    {
+        _btn->setPixels(_frame + start, length, start);
+    }
+    else
+    {
+        sent = _btn->_i2c_writeChanged(0xd0 + start, _btn->_framebuffer + start, _frame + start, length, 2);
+
+        if(_btn->_lastTransferOk)
+            memcpy(_btn->_framebuffer + start, _frame + start, length);
+        else
+            _btn->_framebufferValid = false;
+    }
+
+    // a failed chunk starts the resend over, from the chunk after it
+    if(!_btn->_lastTransferOk)
+    {
+        _resend = false;
+        _pendingSubpixels = ONOFFBTN_FRAMEBUFFER_SIZE;
+    }
+    else
+    {
+        _pendingSubpixels -= length;
+    }
+
+    // round robin: a new frame continues where the previous one stopped, so
+    // every chunk gets its turn even if frames come faster than they're sent
+    _nextSubpixel += length;
+    if(_nextSubpixel >= ONOFFBTN_FRAMEBUFFER_SIZE) _nextSubpixel = 0;
+
+    if(_pendingSubpixels == 0 && _resend)
+    {
+        _btn->_framebufferValid = true;
+        _resend = false;
+    }
+
+    return sent;
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void
+HHTronik_OnOffBTN_Scheduler::notifyInterrupt( void )
+{
+    // keep the time of the first request
+    if(_statusRequested) return;
+
+    _requestTime = micros();
+    _statusRequested = true;
+}
+
+void
+HHTronik_OnOffBTN_Scheduler::queueFrame(const uint8_t *frame)
+{
+    memcpy(_frame, frame, ONOFFBTN_FRAMEBUFFER_SIZE);
+
+    // the copy of the chunks sent so far is accurate, so they're only sent
+    // again where the new frame differs (unless resending). Sending goes on
+    // at the current chunk, all of them are due once more.
+    _pendingSubpixels = ONOFFBTN_FRAMEBUFFER_SIZE;
+}
+
+bool
+HHTronik_OnOffBTN_Scheduler::queueWrite(uint8_t reg, uint8_t value)
+{
+    if(_queueCount >= ONOFFBTN_SCHEDULER_QUEUE_SIZE) return false;
+
+    uint8_t slot = (_queueHead + _queueCount) % ONOFFBTN_SCHEDULER_QUEUE_SIZE;
+    _queue[slot][0] = reg;
+    _queue[slot][1] = value;
+    _queueCount++;
+
+    return true;
+}
+
+bool
+HHTronik_OnOffBTN_Scheduler::poll(uint8_t maxChunks)
+{
+    uint8_t chunks = 0;
+
+    while(true)
+    {
+        _serveUrgent();
+
+        if(_queueCount > 0)
+        {
+            _btn->_i2c_writeByte(_queue[_queueHead][0], _queue[_queueHead][1]);
+            _queueHead = (_queueHead + 1) % ONOFFBTN_SCHEDULER_QUEUE_SIZE;
+            _queueCount--;
+            continue;
+        }
+
+        if(_pendingSubpixels == 0 || chunks >= maxChunks) break;
+
+        // unchanged chunks cost no bus time, they don't count
+        if(_sendChunk() > 0) chunks++;
+    }
+
+    return _pendingSubpixels > 0 || _queueCount > 0;
+}
+
+uint8_t
+HHTronik_OnOffBTN_Scheduler::takeStatus( void )
+{
+    uint8_t status = _status;
+
+    _status &= ~STATUS_EVENTS;
+    _hasStatus = false;
+
+    return status;
+}
+
+#endif
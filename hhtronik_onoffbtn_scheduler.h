@@ -0,0 +1,144 @@
+/**
+    @file     hhtronik_onoffbtn_scheduler.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Prioritized bus traffic for the ÖnÖffBTN: status reads never wait behind
+    LED frames.
+
+    Sending a frame with setPixels() is a 29 byte transfer (~700us at
+    400kHz). A button press that comes in meanwhile is only read once the
+    transfer (and whatever else the loop does) is done. The scheduler queues
+    frames and configuration writes instead, and sends them in pixel-aligned
+    chunks from poll(). Before each chunk it serves, in this order:
+
+      1. status reads, requested by notifyInterrupt() (INT pin ISR) or
+         requestStatus()
+      2. latch/reset commands (register 0x01)
+      3. queued configuration writes
+      4. the next chunk of the queued frame (only the changed subpixels,
+         chunks without changes are skipped)
+
+    So a status read waits for at most one chunk. Chunks are sent round
+    robin: a new frame continues at the chunk where the previous one
+    stopped, so every chunk gets its turn even when frames are queued faster
+    than they're sent (e.g. queueFrame() and poll(1) on every loop). A chunk never splits a
+    pixel: a pixel's color never tears around a status read. Traffic of
+    other devices on the bus is beyond the scheduler's reach.
+
+    While a frame is queued, send frames through the scheduler only.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_SCHEDULER_H_
+#define _HHTRONIK_ONOFFBTN_SCHEDULER_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#define ONOFFBTN_SCHEDULER_QUEUE_SIZE       (8)     // queued configuration writes
+#define ONOFFBTN_SCHEDULER_CHUNK_PIXELS     (3)     // default chunk size
+
+class HHTronik_OnOffBTN_Scheduler {
+ public:
+  /**
+   * @param btn the driver (call begin() on it first)
+   * @param chunkPixels pixels per framebuffer chunk (1 to ONOFFBTN_NUM_PIXELS).
+   * Smaller chunks mean a shorter wait for status reads, but more transfers.
+   */
+  HHTronik_OnOffBTN_Scheduler(HHTronik_OnOffBTN &btn, uint8_t chunkPixels = ONOFFBTN_SCHEDULER_CHUNK_PIXELS);
+
+  /**
+   * Call this from the INT pin ISR: the status gets read before anything
+   * else on the next chunk boundary of poll()
+   */
+  void notifyInterrupt( void );
+
+  /**
+   * Have the status read on the next poll() (when not using the INT pin)
+   */
+  void requestStatus( void ) { notifyInterrupt(); }
+
+  /**
+   * Queue a frame, replacing the one being sent (the frame is copied).
+   * Sending continues at the current chunk.
+   * @param frame ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+   */
+  void queueFrame(const uint8_t *frame);
+
+  /**
+   * Queue a configuration register write
+   * @returns false if the queue is full
+   */
+  bool queueWrite(uint8_t reg, uint8_t value);
+
+  /**
+   * Trigger a latch (see HHTronik_OnOffBTN::TriggerLatch()) on the next poll()
+   */
+  void queueLatch(bool immediate = false) { _command = immediate ? (1 << 1) : 1; }
+
+  /**
+   * Trigger a reset (see HHTronik_OnOffBTN::TriggerReset()) on the next poll()
+   */
+  void queueReset(bool immediate = false) { _command = immediate ? (1 << 3) : (1 << 2); }
+
+  /**
+   * Do the pending bus work
+   * @param maxChunks framebuffer chunks to send at most (0: only serve
+   * status reads, commands and configuration writes), unchanged chunks
+   * don't count
+   * @returns true while frame chunks or configuration writes are pending
+   */
+  bool poll(uint8_t maxChunks = 255);
+
+  /**
+   * true when a status was read that wasn't taken yet
+   */
+  bool hasStatus( void ) { return _hasStatus; }
+
+  /**
+   * The raw status (see ONOFFBTN_STATUS_*): event bits of every read since
+   * the last call are combined, Down and PowerOn are the latest state
+   */
+  uint8_t takeStatus( void );
+
+  /**
+   * Time (in us) from notifyInterrupt() to the end of the status read, for
+   * the last read and the worst since resetStatusLatency()
+   */
+  uint32_t getLastStatusLatency( void ) { return _lastLatency; }
+  uint32_t getWorstStatusLatency( void ) { return _worstLatency; }
+
+  void resetStatusLatency( void ) { _lastLatency = _worstLatency = 0; }
+
+ private:
+  HHTronik_OnOffBTN *_btn;
+  uint8_t _chunkSize;
+
+  volatile bool _statusRequested;
+  volatile uint32_t _requestTime;
+  bool _hasStatus;
+  uint8_t _status;
+  uint32_t _lastLatency;
+  uint32_t _worstLatency;
+
+  uint8_t _command;
+
+  uint8_t _queue[ONOFFBTN_SCHEDULER_QUEUE_SIZE][2];
+  uint8_t _queueHead;
+  uint8_t _queueCount;
+
+  uint8_t _frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+  uint8_t _pendingSubpixels;  // not sent since the frame was queued (or the resend started)
+  bool _resend;
+  uint8_t _nextSubpixel;
+
+  void _serveUrgent( void );
+  uint8_t _sendChunk( void );
+};
+
+#endif // ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#endif
@@ -0,0 +1,224 @@
+/**
+    @file     hhtronik_onoffbtn_timeline.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Keyframe timelines and sequencer for the ÖnÖffBTN LED ring.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_timeline.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#define RUN_KEEP            (0x80)
+#define RUN_COUNT_MASK      (0x0f)
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_Sequencer::HHTronik_OnOffBTN_Sequencer()
+{
+    _timeline = NULL;
+    _next = NULL;
+    _keyframeStart = 0;
+    _duration = 0;
+    _easing = Easing_Step;
+    _loop = false;
+    memset(_from, 0, ONOFFBTN_FRAMEBUFFER_SIZE);
+    memset(_to, 0, ONOFFBTN_FRAMEBUFFER_SIZE);
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+const uint8_t *
+HHTronik_OnOffBTN_Sequencer::_skipKeyframe(const uint8_t *keyframe)
+{
+    uint8_t pixels = 0;
+
+    keyframe += 2;      // duration + easing
+
+    while(pixels < ONOFFBTN_NUM_PIXELS)
+    {
+        uint8_t run = pgm_read_byte(keyframe++);
+        pixels += (run & RUN_COUNT_MASK) + 1;
+
+        if(!(run & RUN_KEEP)) keyframe += 3;
+    }
+
+    return keyframe;
+}
+
+bool
+HHTronik_OnOffBTN_Sequencer::_loadKeyframe( void )
+{
+    uint8_t duration = pgm_read_byte(_next);
+
+    if(duration == 0)
+    {
+        if(!_loop || _next == _timeline) return false;
+
+        // loop: restart from the current colors
+        _next = _timeline;
+        duration = pgm_read_byte(_next);
+    }
+
+    _duration = duration * 10;
+    _easing = pgm_read_byte(_next + 1);
+
+    // the previous target is where we start from
+    memcpy(_from, _to, ONOFFBTN_FRAMEBUFFER_SIZE);
+
+    const uint8_t *data = _next + 2;
+    uint8_t subpixel = 0;
+
+    while(subpixel < ONOFFBTN_FRAMEBUFFER_SIZE)
+    {
+        uint8_t run = pgm_read_byte(data++);
+        uint8_t count = (run & RUN_COUNT_MASK) + 1;
+
+        if(run & RUN_KEEP)
+        {
+            subpixel += count * 3;
+            continue;
+        }
+
+        uint8_t r = pgm_read_byte(data++);
+        uint8_t g = pgm_read_byte(data++);
+        uint8_t b = pgm_read_byte(data++);
+
+        while(count-- && subpixel < ONOFFBTN_FRAMEBUFFER_SIZE)
+        {
+            _to[subpixel++] = r;
+            _to[subpixel++] = g;
+            _to[subpixel++] = b;
+        }
+    }
+
+    _next = data;
+    return true;
+}
+
+uint16_t
+HHTronik_OnOffBTN_Sequencer::_ease(uint8_t easing, uint16_t t)
+{
+    // t and the result are 0 - 256 (8.8 fixed point), squares need 17 bits
+    uint32_t inverse = 256 - t;
+
+    switch(easing)
+    {
+    case Easing_Step:
+        return 256;
+
+    case Easing_EaseIn:
+        return ((uint32_t)t * t) >> 8;
+
+    case Easing_EaseOut:
+        return 256 - ((inverse * inverse) >> 8);
+
+    case Easing_EaseInOut:
+        if(t < 128)
+            return ((uint32_t)t * t) >> 7;
+        return 256 - ((inverse * inverse) >> 7);
+
+    case Easing_Linear:
+    default:
+        return t;
+    }
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+void
+HHTronik_OnOffBTN_Sequencer::play(const uint8_t *timeline, uint32_t now, bool loop)
+{
+    _timeline = timeline;
+    _next = timeline;
+    _loop = loop;
+    _keyframeStart = now;
+
+    // fade in from black
+    memset(_to, 0, ONOFFBTN_FRAMEBUFFER_SIZE);
+
+    if(!_loadKeyframe())
+        _timeline = NULL;
+}
+
+bool
+HHTronik_OnOffBTN_Sequencer::render(uint32_t now, uint8_t *frame)
+{
+    if(_timeline == NULL)
+    {
+        memcpy(frame, _to, ONOFFBTN_FRAMEBUFFER_SIZE);
+        return false;
+    }
+
+    // skip the keyframes we're past
+    while(now - _keyframeStart >= _duration)
+    {
+        _keyframeStart += _duration;
+
+        if(!_loadKeyframe())
+        {
+            _timeline = NULL;
+            memcpy(frame, _to, ONOFFBTN_FRAMEBUFFER_SIZE);
+            return false;
+        }
+    }
+
+    uint16_t t = (uint16_t)(((now - _keyframeStart) << 8) / _duration);
+    uint16_t eased = _ease(_easing, t);
+
+    // unsigned 16 bit math only, this is the per-frame hot path on AVR
+    for(uint8_t i = 0; i < ONOFFBTN_FRAMEBUFFER_SIZE; i++)
+    {
+        uint8_t from = _from[i];
+        uint8_t to = _to[i];
+
+        if(to >= from)
+            frame[i] = from + (uint8_t)(((uint16_t)(to - from) * eased) >> 8);
+        else
+            frame[i] = from - (uint8_t)(((uint16_t)(from - to) * eased) >> 8);
+    }
+
+    return true;
+}
+
+bool
+HHTronik_OnOffBTN_Sequencer::update(HHTronik_OnOffBTN &btn, uint32_t now)
+{
+    uint8_t frame[ONOFFBTN_FRAMEBUFFER_SIZE];
+    bool playing = render(now, frame);
+
+    btn.updateFramebuffer(frame);
+    return playing;
+}
+
+uint16_t
+HHTronik_OnOffBTN_Sequencer::getTimelineSize(const uint8_t *timeline)
+{
+    const uint8_t *keyframe = timeline;
+
+    while(pgm_read_byte(keyframe) != 0)
+        keyframe = _skipKeyframe(keyframe);
+
+    return (keyframe - timeline) + 1;   // including the end marker
+}
+
+uint32_t
+HHTronik_OnOffBTN_Sequencer::getTimelineDuration(const uint8_t *timeline)
+{
+    uint32_t duration = 0;
+
+    while(pgm_read_byte(timeline) != 0)
+    {
+        duration += pgm_read_byte(timeline) * 10;
+        timeline = _skipKeyframe(timeline);
+    }
+
+    return duration;
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+    @file     hhtronik_onoffbtn_timeline.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    Compact keyframe timelines for the ÖnÖffBTN LED ring, stored in flash
+    (PROGMEM) and played back by a sequencer that interpolates between
+    keyframes on the host.
+
+    Timeline format (bytes):
+
+      keyframe:   [duration / 10ms] [easing]  run, run, ... (covering the 9 pixels)
+      run:        [0b0000nnnn] [r] [g] [b]    n+1 pixels fade to (r, g, b)
+                  [0b1000nnnn]                n+1 pixels keep their previous color
+      end:        [0]
+
+    Each keyframe describes the colors reached at the end of its duration,
+    the first keyframe fades in from black. Build timelines with the macros
+    below:
+
+      const uint8_t bootShow[] PROGMEM = {
+        ONOFFBTN_KEYFRAME(500, Easing_EaseOut), ONOFFBTN_COLOR(9, 0, 0, 255),
+        ONOFFBTN_KEYFRAME(300, Easing_Linear),  ONOFFBTN_COLOR(3, 255, 255, 255), ONOFFBTN_KEEP(6),
+        ONOFFBTN_KEYFRAME(800, Easing_EaseIn),  ONOFFBTN_COLOR(9, 0, 0, 0),
+        ONOFFBTN_TIMELINE_END
+      };
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_TIMELINE_H_
+#define _HHTRONIK_ONOFFBTN_TIMELINE_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_FRAMEBUFFER
+
+// keyframe header, duration in ms: 10 to 2550ms in steps of 10ms (rounded
+// down). The duration is stored as a byte of 10ms units and 0 ends the
+// timeline, so a duration out of range doesn't compile (negative array
+// size): split longer fades into several keyframes.
+#define ONOFFBTN_KEYFRAME(durationMs, easing)   ONOFFBTN_KEYFRAME_DURATION(durationMs), (uint8_t)(easing)
+
+#define ONOFFBTN_KEYFRAME_DURATION(durationMs)  \
+  (uint8_t)(sizeof(char[(durationMs) >= 10 && (durationMs) <= 2550 ? 1 : -1]) * ((durationMs) / 10))
+
+// "count" pixels fade to the given color
+#define ONOFFBTN_COLOR(count, r, g, b)          (uint8_t)((count) - 1), (uint8_t)(r), (uint8_t)(g), (uint8_t)(b)
+
+// "count" pixels keep their color
+#define ONOFFBTN_KEEP(count)                    (uint8_t)(0x80 | ((count) - 1))
+
+#define ONOFFBTN_TIMELINE_END                   (uint8_t)(0)
+
+typedef enum {
+  Easing_Step       = 0,    // jump to the keyframe colors, then hold them
+  Easing_Linear     = 1,
+  Easing_EaseIn     = 2,    // quadratic, slow start
+  Easing_EaseOut    = 3,    // quadratic, slow end
+  Easing_EaseInOut  = 4     // quadratic, slow start and end
+} OnOffBTN_Easing;
+
+class HHTronik_OnOffBTN_Sequencer {
+ public:
+  HHTronik_OnOffBTN_Sequencer();
+
+  /**
+   * Start playing a timeline
+   * @param timeline pointer to the timeline in flash (PROGMEM)
+   * @param now current time in ms (millis())
+   * @param loop restart the timeline (from the last colors) when it ends
+   */
+  void play(const uint8_t *timeline, uint32_t now, bool loop = false);
+
+  /**
+   * Stop playing, the LED ring keeps the last frame
+   */
+  void stop( void ) { _timeline = NULL; }
+
+  /**
+   * Compute the frame for the given time
+   * @param now current time in ms (millis())
+   * @param frame destination buffer of ONOFFBTN_FRAMEBUFFER_SIZE subpixels
+   * @returns false once the timeline has ended (frame then holds the final colors)
+   */
+  bool render(uint32_t now, uint8_t *frame);
+
+  /**
+   * Compute the frame for the given time and send it to the ÖnÖffBTN. Call
+   * this as often as your frame rate requires.
+   * @returns false once the timeline has ended
+   */
+  bool update(HHTronik_OnOffBTN &btn, uint32_t now);
+
+  /**
+   * true while a timeline is playing
+   */
+  bool isPlaying( void ) { return _timeline != NULL; }
+
+  /**
+   * Size of a timeline in flash (bytes)
+   */
+  static uint16_t getTimelineSize(const uint8_t *timeline);
+
+  /**
+   * Duration of a timeline (ms)
+   */
+  static uint32_t getTimelineDuration(const uint8_t *timeline);
+
+ private:
+  const uint8_t *_timeline;
+  const uint8_t *_next;
+  uint32_t _keyframeStart;
+  uint16_t _duration;
+  uint8_t _easing;
+  bool _loop;
+
+  uint8_t _from[ONOFFBTN_FRAMEBUFFER_SIZE];
+  uint8_t _to[ONOFFBTN_FRAMEBUFFER_SIZE];
+
+  bool _loadKeyframe( void );
+  static const uint8_t *_skipKeyframe(const uint8_t *keyframe);
+  static uint16_t _ease(uint8_t easing, uint16_t t);
+};
+
+#endif // ONOFFBTN_ENABLE_FRAMEBUFFER
+
+#endif
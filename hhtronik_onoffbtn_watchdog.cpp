@@ -0,0 +1,161 @@
+/**
+    @file     hhtronik_onoffbtn_watchdog.cpp
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    External watchdog built on the ÖnÖffBTN RTC.
+
+    Visit https://hhtronik.com for more information
+*/
+#include "hhtronik_onoffbtn_watchdog.h"
+
+#if ONOFFBTN_ENABLE_RTC
+
+#define SECONDS_PER_DAY (86400UL)
+
+/////////////////////////////////////////////////////////
+// Constructors:
+
+HHTronik_OnOffBTN_Watchdog::HHTronik_OnOffBTN_Watchdog(HHTronik_OnOffBTN &btn)
+{
+    _btn = &btn;
+    _armed = false;
+    _timeout = 0;
+    _length = 3;
+    _rtcBase = 0;
+    _millisBase = 0;
+    _nextKick = 0;
+    memset(_alarm, 0, sizeof(_alarm));
+}
+
+/////////////////////////////////////////////////////////
+// Private:
+
+bool
+HHTronik_OnOffBTN_Watchdog::_sync( void )
+{
+    uint8_t time[3];
+
+    // RTC seconds, minutes, hours (24h format)
+    if(_btn->_i2c_readBytes(0xb1, time, 3) != 3) return false;
+
+    _millisBase = millis();
+    _rtcBase = OnOffBTN_bcdToDec(time[0] & 0x7f)
+             + OnOffBTN_bcdToDec(time[1] & 0x7f) * 60UL
+             + OnOffBTN_bcdToDec(time[2] & 0x3f) * 3600UL;
+    _nextKick = 0;
+
+    return true;
+}
+
+void
+HHTronik_OnOffBTN_Watchdog::_computeAlarm(uint32_t elapsed, uint8_t *alarm)
+{
+    // wraps around at midnight, the alarm day/date is masked
+    uint32_t at = (_rtcBase + elapsed / 1000 + _timeout) % SECONDS_PER_DAY;
+
+    alarm[0] = OnOffBTN_encodeAlarmComponent(at % 60, false, ONOFFBTN_RTC_MAX_SECONDS);           // ALMAR1
+    alarm[1] = OnOffBTN_encodeAlarmComponent((at / 60) % 60, _length < 2, ONOFFBTN_RTC_MAX_MINUTES); // ALMAR2
+    alarm[2] = OnOffBTN_encodeAlarmComponent(at / 3600, _length < 3, ONOFFBTN_RTC_MAX_HOURS);      // ALMAR3
+}
+
+/////////////////////////////////////////////////////////
+// Public:
+
+bool
+HHTronik_OnOffBTN_Watchdog::arm(uint16_t timeout, OnOffBTN_DelayValue cancelationDelay)
+{
+    if(timeout < ONOFFBTN_WATCHDOG_MIN_TIMEOUT) timeout = ONOFFBTN_WATCHDOG_MIN_TIMEOUT;
+
+    _armed = false;
+    _timeout = timeout;
+
+    // only maintain the alarm components the timeout can reach
+    if(timeout < 60) _length = 1;
+    else if(timeout < 3600) _length = 2;
+    else _length = 3;
+
+    OnOffBTN_RTCControlRegister config = {
+        .AlarmEnabled = true,
+        .AlarmAction = RTCAlarm_Reset,
+        .AlarmAutoRearm = true,             // keep resetting a host that hangs while booting
+        .UseAmPmFormat = false,
+        .AlarmCancelationDelay = cancelationDelay
+    };
+
+    uint8_t wanted = OnOffBTN_encodeRTCControl(config);
+    uint8_t current = _btn->_i2c_readByte(0xb0);
+
+    // the time estimate needs the 24h format: switch over first, with the
+    // alarm disabled so the stale alarm time can't fire in between
+    if(current != wanted && OnOffBTN_decodeRTCControl(current).UseAmPmFormat)
+    {
+        config.AlarmEnabled = false;
+        current = OnOffBTN_encodeRTCControl(config);
+        _btn->_i2c_writeByte(0xb0, current);
+        delay(ONOFFBTN_RTC_COMMIT_TIME);
+    }
+
+    if(!_sync()) return false;
+
+    uint8_t alarm[4];
+    _computeAlarm(0, alarm);
+    alarm[3] = OnOffBTN_encodeAlarmDayDate({
+        .Value = 0,
+        .IsWeekDayAlarm = false,
+        .DayDateMasked = true               // every day
+    });
+
+    _btn->_i2c_writeBytes(0xb8, alarm, 4);
+    memcpy(_alarm, alarm, sizeof(_alarm));
+    _nextKick = 1000;
+
+    if(current != wanted)
+    {
+        // leave the bus to the RTC commit, the alarm written above is still
+        // ahead afterwards (timeout >= 2s)
+        _btn->_i2c_writeByte(0xb0, wanted);
+        delay(ONOFFBTN_RTC_COMMIT_TIME);
+    }
+
+    _armed = true;
+    return true;
+}
+
+void
+HHTronik_OnOffBTN_Watchdog::kick( void )
+{
+    if(!_armed) return;
+
+    uint32_t elapsed = millis() - _millisBase;
+
+    // the alarm already sits at the right second
+    if(elapsed < _nextKick) return;
+
+    if(elapsed >= ONOFFBTN_WATCHDOG_RESYNC_INTERVAL && _sync())
+        elapsed = millis() - _millisBase;
+
+    uint8_t alarm[3];
+    _computeAlarm(elapsed, alarm);
+
+    // usually only ALMAR1 changed: a single byte burst to 0xb8
+    _btn->_i2c_writeChanged(0xb8, _alarm, alarm, _length, 1);
+    memcpy(_alarm, alarm, _length);
+
+    _nextKick = (elapsed / 1000 + 1) * 1000;
+}
+
+void
+HHTronik_OnOffBTN_Watchdog::disarm( void )
+{
+    _armed = false;
+
+    OnOffBTN_RTCControlRegister config = OnOffBTN_decodeRTCControl(_btn->_i2c_readByte(0xb0));
+    if(!config.AlarmEnabled) return;
+
+    config.AlarmEnabled = false;
+    _btn->_i2c_writeByte(0xb0, OnOffBTN_encodeRTCControl(config));
+    delay(ONOFFBTN_RTC_COMMIT_TIME);
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+    @file     hhtronik_onoffbtn_watchdog.h
+    @author   Yannic Staudt (HHTronik)
+    @license  BSD (see licence.txt)
+
+    External watchdog built on the ÖnÖffBTN RTC: when the host stops kicking
+    it, the RTC alarm fires with the RTCAlarm_Reset action and the ÖnÖffBTN
+    power-cycles the host.
+
+    arm() programs the RTC once (the RTC control register is only written
+    when it differs, its commit takes ~500ms). kick() then moves the alarm
+    forward from a time estimate kept with millis(), so it doesn't read the
+    RTC: it only writes once per second, and only the alarm registers that
+    the timeout needs (ALMAR1 alone for timeouts under a minute, ALMAR1-2
+    under an hour, ALMAR1-3 otherwise), in a single burst starting at 0xb8.
+    The estimate is resynchronized with the RTC every
+    ONOFFBTN_WATCHDOG_RESYNC_INTERVAL ms to cancel out the drift of millis().
+
+    The RTC has a one second resolution, so the alarm fires between
+    timeout - 1 and timeout seconds after the last kick.
+
+    Visit https://hhtronik.com for more information
+*/
+
+#ifndef _HHTRONIK_ONOFFBTN_WATCHDOG_H_
+#define _HHTRONIK_ONOFFBTN_WATCHDOG_H_
+
+#include "hhtronik_onoffbtn.h"
+
+#if ONOFFBTN_ENABLE_RTC
+
+#define ONOFFBTN_WATCHDOG_MIN_TIMEOUT       (2)         // s
+#define ONOFFBTN_WATCHDOG_RESYNC_INTERVAL   (60000)     // ms
+
+class HHTronik_OnOffBTN_Watchdog {
+ public:
+  /**
+   * @param btn the driver of the ÖnÖffBTN powering the host (call begin() on it first)
+   */
+  HHTronik_OnOffBTN_Watchdog(HHTronik_OnOffBTN &btn);
+
+  /**
+   * Start the watchdog. This takes over the RTC alarm: the alarm is set to
+   * RTCAlarm_Reset with auto-rearm and the RTC is switched to the 24h format.
+   * When the RTC configuration already matches (i.e. after a reset by the
+   * watchdog) arming only costs a few bytes on the bus, otherwise it waits
+   * ~500ms (~1s if the RTC used the AM/PM format) for the RTC to commit, so
+   * no other transfer can disturb it.
+   *
+   * @param timeout time (in s, ONOFFBTN_WATCHDOG_MIN_TIMEOUT to 65535) without
+   * kick() after which the host gets reset
+   * @param cancelationDelay time the host has to cancel the reset (Latch pin)
+   * @returns false if the RTC couldn't be read
+   */
+  bool arm(uint16_t timeout, OnOffBTN_DelayValue cancelationDelay = delay100ms);
+
+  /**
+   * Push the alarm forward. Cheap enough to be called from a hot loop: the
+   * bus is only used when the alarm has to move (once per second)
+   */
+  void kick( void );
+
+  /**
+   * Stop the watchdog (disables the RTC alarm, waits ~500ms for the RTC
+   * to commit when it was enabled)
+   */
+  void disarm( void );
+
+  /**
+   * true while the watchdog is armed
+   */
+  bool isArmed( void ) { return _armed; }
+
+  /**
+   * Configured timeout (s)
+   */
+  uint16_t getTimeout( void ) { return _timeout; }
+
+ private:
+  HHTronik_OnOffBTN *_btn;
+  bool _armed;
+  uint16_t _timeout;
+  uint8_t _length;            // alarm registers kick() has to maintain (1 to 3)
+
+  uint32_t _rtcBase;          // RTC second of the day at _millisBase
+  uint32_t _millisBase;
+  uint32_t _nextKick;         // ms after _millisBase at which the alarm has to move
+
+  uint8_t _alarm[3];          // ALMAR1-3 as last written
+
+  bool _sync( void );
+  void _computeAlarm(uint32_t elapsed, uint8_t *alarm);
+};
+
+#endif // ONOFFBTN_ENABLE_RTC
+
+#endif